@@ -0,0 +1,471 @@
+#define BATCH_LINE_SIZE 256           //longest instance line accepted, newline included
+#define BATCH_OUTPUT_BUFFER (1 << 16) //bytes of output buffered before each write
+#define BATCH_BLOCK_SIZE 8192         //instances read, solved in parallel, then written at once
+
+//this enumerates the search engines a batch can be solved with
+typedef enum Engine {
+    ENGINE_ASTAR, ENGINE_IDASTAR, ENGINE_BFS, ENGINE_BIDIRECTIONAL, ENGINE_WEIGHTED, ENGINE_ANYTIME, ENGINE_HDA,
+    ENGINE_SMA
+} Engine;
+
+/**
+ * DESCRIPTION:
+ *    This looks up the engine named `name`, i.e. "astar", "idastar", "bfs", "bibfs",
+ *    "wastar", "arastar", "hdastar" or "smastar".
+ * RETURN:
+ *    Returns 1 if `engine` is written, 0 if no engine has that name.
+**/
+char parseEngine(char const *name, Engine * const engine) {
+    if(!strcmp(name, "astar"))
+        *engine = ENGINE_ASTAR;
+    else if(!strcmp(name, "idastar"))
+        *engine = ENGINE_IDASTAR;
+    else if(!strcmp(name, "bfs"))
+        *engine = ENGINE_BFS;
+    else if(!strcmp(name, "bibfs"))
+        *engine = ENGINE_BIDIRECTIONAL;
+    else if(!strcmp(name, "wastar"))
+        *engine = ENGINE_WEIGHTED;
+    else if(!strcmp(name, "arastar"))
+        *engine = ENGINE_ANYTIME;
+    else if(!strcmp(name, "hdastar"))
+        *engine = ENGINE_HDA;
+    else if(!strcmp(name, "smastar"))
+        *engine = ENGINE_SMA;
+    else
+        return 0;
+    return 1;
+}
+
+//this enumerates the heuristics A* and IDA* can be guided by
+typedef enum HeuristicKind {
+    HEURISTIC_MANHATTAN, HEURISTIC_CONFLICT, HEURISTIC_WALKING, HEURISTIC_PATTERN
+} HeuristicKind;
+
+/**
+ * DESCRIPTION:
+ *    This looks up the heuristic named `name`, i.e. "manhattan", "conflict" or
+ *    "walking". Pattern databases are chosen by giving their file instead.
+ * RETURN:
+ *    Returns 1 if `kind` is written, 0 if no heuristic has that name.
+**/
+char parseHeuristic(char const *name, HeuristicKind * const kind) {
+    if(!strcmp(name, "manhattan"))
+        *kind = HEURISTIC_MANHATTAN;
+    else if(!strcmp(name, "conflict"))
+        *kind = HEURISTIC_CONFLICT;
+    else if(!strcmp(name, "walking"))
+        *kind = HEURISTIC_WALKING;
+    else
+        return 0;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    The heuristic chosen for A* and IDA*, along with the tables it has built for
+ *    the goal it is prepared for. The tables only hold for that goal, so it is
+ *    prepared again whenever the goal changes.
+**/
+typedef struct GoalHeuristic {
+    HeuristicKind kind;        //the heuristic chosen
+    char const *pdbPath;       //file of the pattern databases, for HEURISTIC_PATTERN
+    ExternalOptions const *external; //where pattern databases are built on disk; NULL to build them in memory
+    char isPrepared;           //set once the tables below are built for `goal`
+    State goal;                //the goal the tables are built for
+    ConflictTable conflicts;   //tables of HEURISTIC_CONFLICT
+    WalkingDistance walking;   //tables of HEURISTIC_WALKING
+    PatternHeuristic patterns; //databases of HEURISTIC_PATTERN
+    Heuristic heuristic;       //lookups of the tables
+} GoalHeuristic;
+
+/**
+ * DESCRIPTION: This chooses the heuristic `kind`, to be prepared for each goal later.
+**/
+void initGoalHeuristic(GoalHeuristic * const heuristic, HeuristicKind kind, char const *pdbPath) {
+    heuristic->kind = kind;
+    heuristic->pdbPath = pdbPath;
+    heuristic->external = NULL;
+    heuristic->isPrepared = 0;
+}
+
+/**
+ * DESCRIPTION: This releases the tables of `heuristic`, if it is prepared.
+**/
+void destroyGoalHeuristic(GoalHeuristic * const heuristic) {
+    if(!heuristic->isPrepared)
+        return;
+
+    if(heuristic->kind == HEURISTIC_WALKING)
+        destroyWalkingDistance(&heuristic->walking);
+    else if(heuristic->kind == HEURISTIC_PATTERN)
+        destroyPatternHeuristic(&heuristic->patterns);
+    heuristic->isPrepared = 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds the tables of `heuristic` for `goal`, unless they already are.
+ *    Errors are reported on the standard error.
+ * RETURN:
+ *    Returns the heuristic to pass to the engines, which is NULL for the
+ *    Manhattan distance, in `*result`. Returns 1 on success; 0 if the tables
+ *    cannot be built for this board or memory runs out.
+**/
+char prepareGoalHeuristic(GoalHeuristic * const heuristic, State const *goal, Heuristic const **result) {
+    char success = 1;
+
+    *result = NULL;
+    if(heuristic->kind == HEURISTIC_MANHATTAN)
+        return 1;
+
+    if(heuristic->isPrepared && statesMatch(&heuristic->goal, goal)) {
+        *result = &heuristic->heuristic;
+        return 1;
+    }
+    destroyGoalHeuristic(heuristic);
+
+    switch(heuristic->kind) {
+        case HEURISTIC_CONFLICT:
+            if((success = buildConflictTable(goal, &heuristic->conflicts)))
+                useConflicts(&heuristic->heuristic, &heuristic->conflicts);
+            else
+                fprintf(stderr, "ERROR: Linear conflicts need rows and columns of at most %d cells.\n",
+                    CONFLICT_LINE_LIMIT);
+            break;
+        case HEURISTIC_WALKING:
+            if((success = buildWalkingDistance(goal, &heuristic->walking)))
+                useWalking(&heuristic->heuristic, &heuristic->walking);
+            else
+                fprintf(stderr, "ERROR: Walking distances need at most %d rows and columns.\n", WALKING_LINE_LIMIT);
+            break;
+        default:
+            if((success = preparePatternHeuristic(&heuristic->patterns, heuristic->pdbPath, goal, heuristic->external)))
+                usePatternDatabases(&heuristic->heuristic, &heuristic->patterns);
+            else
+                fprintf(stderr, "ERROR: Not enough memory to build the pattern databases.\n");
+            break;
+    }
+
+    if(!success)
+        return 0;
+
+    heuristic->goal = *goal;
+    heuristic->isPrepared = 1;
+    *result = &heuristic->heuristic;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This solves a single instance, recording its statistics in `context`. It is
+ *    looked up in the distance table if there is one for its goal, then in the
+ *    solution cache if there is one, and solved with `engine` otherwise; the
+ *    solutions of `engine` are then added to the cache. The open list and closed
+ *    set of `engine` grow within `memoryLimit`, and an instance `engine` runs out
+ *    of memory on is solved again by SMA* within the same budget.
+ * PARAMETERS:
+ *    engine    - the search engine to use
+ *    context   - the search context to run in
+ *    initial   - the initial state
+ *    goal      - the goal state
+ *    heuristic - the heuristic of A* and IDA*; NULL for the Manhattan distance
+ *    table     - the distance table to look instances up in; may be NULL
+ *    cache     - the solutions of earlier instances; may be NULL
+ *    threadCount - the number of threads of HDA*
+ *    options   - the weight of weighted A*, and the schedule and limits of the anytime A*
+ *    memoryLimit - the bytes the search may hold
+ * RETURN:
+ *    Returns the solution path of the engine; NULL if there is none.
+**/
+SolutionPath* solveInstance(Engine engine, SearchContext * const context, State *initial, State *goal,
+        Heuristic const *heuristic, DistanceTable const *table, SolutionCache * const cache, unsigned int threadCount,
+        AnytimeOptions const *options, size_t memoryLimit) {
+    SolutionPath *path;
+    unsigned long hits = 0, misses = 0;
+
+    context->memoryLimit = memoryLimit;
+    if(table && statesMatch(&table->goal, goal))
+        return Table_search(context, table, initial, goal);
+
+    if(cache) {
+        if((path = Cache_search(context, cache, initial, goal)))
+            return path;
+        hits = context->stats.cacheHits;
+        misses = context->stats.cacheMisses;
+    }
+
+    switch(engine) {
+        case ENGINE_IDASTAR:
+            path = IDAStar_search(context, initial, goal, heuristic);
+            break;
+        case ENGINE_BFS:
+            path = BFS_search(context, initial, goal);
+            break;
+        case ENGINE_BIDIRECTIONAL:
+            path = BidirectionalBFS_search(context, initial, goal);
+            break;
+        case ENGINE_WEIGHTED:
+            path = WeightedAStar_search(context, initial, goal, heuristic, options->weight);
+            break;
+        case ENGINE_ANYTIME:
+            path = AnytimeAStar_search(context, initial, goal, heuristic, options);
+            break;
+        case ENGINE_HDA:
+            path = HDAStar_search(context, initial, goal, heuristic, threadCount);
+            break;
+        case ENGINE_SMA:
+            path = SMAStar_search(context, initial, goal, heuristic, memoryLimit);
+            break;
+        default:
+            path = AStar_search(context, initial, goal, heuristic);
+            break;
+    }
+
+    //rather than fail, trade time for memory; the closed set is released first, so
+    //that SMA* has the whole budget
+    if(!path && context->stats.isOutOfMemory && engine != ENGINE_SMA) {
+        destroyClosedSet(&context->closed);
+        path = SMAStar_search(context, initial, goal, heuristic, memoryLimit);
+    }
+
+    if(cache) {
+        context->stats.cacheHits = hits;
+        context->stats.cacheMisses = misses;
+        if(path)
+            storeSolution(cache, initial, goal, path, context->stats.solutionLength);
+    }
+    return path;
+}
+
+/**
+ * DESCRIPTION: An instance line of a batch and, once solved, its result.
+**/
+typedef struct BatchInstance {
+    State initial;             //the initial state
+    State goal;                //the goal state
+    char isValid;              //set if the line is a valid instance
+    SearchStats stats;         //statistics of the search
+    SolutionPath *path;        //solution path returned by the search
+} BatchInstance;
+
+/**
+ * DESCRIPTION: A block of instances handed to the thread pool.
+**/
+typedef struct BatchBlock {
+    BatchInstance *instances;  //the instances of the block
+    Engine engine;             //the engine to solve them with
+    Heuristic const *heuristic; //the heuristic of A* and IDA*; NULL for the Manhattan distance
+    DistanceTable const *table; //the distance table to look instances up in; may be NULL
+    SolutionCache *cache;      //the solutions of earlier instances; may be NULL
+    unsigned int threadCount;  //the number of threads of HDA*
+    AnytimeOptions const *options; //the options of weighted and anytime A*
+    size_t memoryLimit;        //the bytes each search may hold
+} BatchBlock;
+
+/**
+ * DESCRIPTION: The pool task solving instance `index` of a `BatchBlock`.
+**/
+void solveBatchInstance(void *data, unsigned int index, SearchContext *context) {
+    BatchBlock *block = data;
+    BatchInstance *instance = &block->instances[index];
+
+    if(!instance->isValid)
+        return;
+
+    instance->path = solveInstance(block->engine, context, &instance->initial, &instance->goal,
+        block->heuristic, block->table, block->cache, block->threadCount,
+        block->options, block->memoryLimit);
+    PROFILE_STOP(context);
+    instance->stats = context->stats;
+}
+
+/**
+ * DESCRIPTION:
+ *    This reads the next instance line of `input`, skipping blank lines and
+ *    lines starting with '#'.
+ * PARAMETERS:
+ *    input      - the stream of instances
+ *    instance   - where the instance is written to; it is marked invalid if the
+ *                 line is not a valid instance
+ *    lineNumber - the number of the last line read, for error messages
+ * RETURN:
+ *    Returns 1 if a line is read, 0 at the end of the input.
+**/
+char readInstance(FILE *input, BatchInstance * const instance, unsigned long * const lineNumber) {
+    char line[BATCH_LINE_SIZE];
+    char const *text;
+    char isSkipped;
+    int c;
+
+    while(fgets(line, sizeof(line), input)) {
+        ++*lineNumber;
+        text = line;
+        while(*text == ' ' || *text == '\t')
+            ++text;
+
+        isSkipped = *text == '#' || *text == '\n' || *text == '\r' || !*text;
+        if(!isSkipped) {
+            instance->path = NULL;
+            memset(&instance->stats, 0, sizeof(instance->stats));
+            instance->isValid = parseState(&text, &instance->initial) && parseState(&text, &instance->goal);
+
+            if(!instance->isValid)
+                fprintf(stderr, "ERROR: Line %lu is not a valid instance.\n", *lineNumber);
+        }
+
+        //skip the rest of a line that did not fit in the buffer, so that it is not
+        //read as a line of its own
+        if(!strchr(line, '\n')) {
+            while((c = fgetc(input)) != EOF && c != '\n');
+        }
+
+        if(!isSkipped)
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    The non-interactive mode. Instances are streamed from `input`, one per line
+ *    as the initial and goal boards in the format of `parseState()`:
+ *        281463750 123804765
+ *    Blank lines and lines starting with '#' are skipped. Every other line gets
+ *    exactly one result line from `printResultLine()` on the standard output, in
+ *    input order; lines that are not valid instances get "invalid". Instances are
+ *    read in blocks of BATCH_BLOCK_SIZE, which are solved by a pool of threads
+ *    and then written out, fully buffered, so that writing results costs next to
+ *    nothing.
+ * PARAMETERS:
+ *    input       - the stream of instances
+ *    engine      - the search engine to solve every instance with
+ *    heuristic   - the heuristic of A* and IDA*. Unless it is the Manhattan
+ *                  distance, its tables are prepared again whenever the goal
+ *                  changes, so instances are best grouped by goal.
+ *    tablePath   - file of the distance table to look instances up in; NULL for
+ *                  none. The table is mapped whatever its goal, or built for the
+ *                  goal of the first valid instance if the file does not hold one;
+ *                  instances of other goals are solved with `engine`.
+ *    cacheSize   - number of solutions the threads share in a cache, so that
+ *                  instances seen before, or equal to one up to the names of
+ *                  their tiles, are not searched again; 0 for none
+ *    threadCount - number of threads solving instances, one at a time with all of
+ *                  them for HDA*, and in parallel otherwise
+ *    options     - the weight of weighted A*, and the schedule and time limit of
+ *                  the anytime A*; its `report` is called from the solver threads
+ *    memoryLimit - the bytes each search may hold, per thread
+ * RETURN:
+ *    Returns 0 if every line was solved, 1 otherwise.
+**/
+int solveBatch(FILE *input, Engine engine, GoalHeuristic * const heuristic, char const *tablePath, size_t cacheSize,
+        unsigned int threadCount, AnytimeOptions const *options, size_t memoryLimit) {
+    BatchInstance *instances = malloc((BATCH_BLOCK_SIZE + 1) * sizeof(BatchInstance));
+    BatchInstance const *leader; //the first valid instance of the block, whose goal the tables are for
+    BatchBlock block = { instances, engine, NULL, NULL, NULL, engine == ENGINE_HDA? threadCount : 1, options,
+        memoryLimit };
+    DistanceTable table;
+    SolutionCache cache;
+    ThreadPool pool;
+    unsigned long lineNumber = 0, solvedCount = 0;
+    unsigned int count, i;
+    char hasPending = 0;       //set if an instance was read ahead into `instances[count]`
+    int status = 0;
+
+    if(!instances || !createPool(&pool, engine == ENGINE_HDA? 1 : threadCount)) {
+        fprintf(stderr, "ERROR: Could not start the solver threads.\n");
+        free(instances);
+        return 1;
+    }
+
+    if(cacheSize) {
+        if(createSolutionCache(&cache, cacheSize))
+            block.cache = &cache;
+        else
+            fprintf(stderr, "WARNING: Not enough memory for the solution cache.\n");
+    }
+
+    setvbuf(stdout, NULL, _IOFBF, BATCH_OUTPUT_BUFFER);
+    double start = readClock();
+
+    do {
+        //carry over the instance read ahead by the previous block
+        count = 0;
+        leader = NULL;
+        if(hasPending) {
+            instances[count] = instances[BATCH_BLOCK_SIZE];
+            leader = &instances[count++];
+        }
+        hasPending = 0;
+
+        while(count < BATCH_BLOCK_SIZE && readInstance(input, &instances[count], &lineNumber)) {
+            if(!instances[count].isValid) {
+                ++count;
+                continue;
+            }
+
+            //with tables built for a goal, a block only holds instances of a single goal
+            if(heuristic->kind != HEURISTIC_MANHATTAN && leader && !statesMatch(&instances[count].goal, &leader->goal)) {
+                instances[BATCH_BLOCK_SIZE] = instances[count];
+                hasPending = 1;
+                break;
+            }
+            if(!leader)
+                leader = &instances[count];
+            ++count;
+        }
+
+        //the heuristic's tables only hold for the goal they were built for
+        if(leader && !prepareGoalHeuristic(heuristic, &leader->goal, &block.heuristic)) {
+            status = 1;
+            break;
+        }
+
+        //the table is prepared once, for the goal of the first valid instance
+        if(tablePath && !block.table && leader) {
+            if(loadDistanceTable(&table, tablePath, NULL)
+                    || prepareDistanceTable(&table, tablePath, &leader->goal)) {
+                block.table = &table;
+            }
+            else {
+                fprintf(stderr, "WARNING: No distance table can be built for this board.\n");
+                tablePath = NULL;
+            }
+        }
+
+        runPool(&pool, count, solveBatchInstance, &block);
+
+        for(i = 0; i < count; ++i) {
+            if(!instances[i].isValid) {
+                printf("invalid 0 0 0 0.000\n");
+                status = 1;
+                continue;
+            }
+
+            printResultLine(stdout, &instances[i].stats, instances[i].path);
+            if(!instances[i].path && !instances[i].stats.isUnsolvable)
+                status = 1;
+            destroySolution(&instances[i].path);
+            ++solvedCount;
+        }
+    } while(count > 0 || hasPending);
+
+    fflush(stdout);
+
+    double elapsed = readClock() - start;
+    fprintf(stderr, "Solved %lu instances in %.3f seconds (%.0f instances/sec) with %u threads.\n",
+        solvedCount, elapsed, elapsed > 0? solvedCount / elapsed : 0.0, pool.workerCount * block.threadCount);
+
+    if(block.cache) {
+        fprintf(stderr, "Solution cache: %lu hits, %lu misses.\n", cache.hits, cache.misses);
+        destroySolutionCache(&cache);
+    }
+    destroyGoalHeuristic(heuristic);
+    if(block.table)
+        destroyDistanceTable(&table);
+    destroyPool(&pool);
+    free(instances);
+
+    return status;
+}
@@ -0,0 +1,452 @@
+/**
+ * DESCRIPTION:
+ *    The benchmark suite. Every engine solves the README test cases and a set of
+ *    random solvable instances at controlled optimal depths, generated from a
+ *    fixed seed so that every run of the suite solves the same boards. Engines
+ *    guided by a heuristic solve them once with each heuristic (SMA* within a
+ *    budget small enough to make it forget nodes), and HDA* solves them with
+ *    1, 2, 4, ... up to `--threads` threads, its speedup over the serial A*
+ *    telling how it scales. Each case is solved repeatedly, at least `--runs`
+ *    times and until `--time` seconds of wall-clock time have been accumulated,
+ *    and the results are written as a table, CSV or JSON for comparison between
+ *    versions.
+ * USAGE:
+ *    Benchmark [--format table|csv|json] [--seed N] [--count N] [--runs N] [--time SECONDS] [--threads N]
+**/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+#include<time.h>
+#include<limits.h>
+#ifndef _WIN32
+#include<sys/resource.h>
+#endif
+
+static unsigned long allocationCount; //number of calls to malloc, calloc and realloc
+
+//the allocation functions counted by the benchmark; the headers below are
+//compiled with these in place of the standard ones
+static void* countedMalloc(size_t size) {
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+static void* countedCalloc(size_t count, size_t size) {
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return calloc(count, size);
+}
+
+static void* countedRealloc(void *object, size_t size) {
+    __atomic_fetch_add(&allocationCount, 1, __ATOMIC_RELAXED);
+    return realloc(object, size);
+}
+
+#define malloc countedMalloc
+#define calloc countedCalloc
+#define realloc countedRealloc
+
+#include "profile.h"
+#include "state.h"
+#include "closed.h"
+#include "context.h"
+#include "heuristic.h"
+#include "node.h"
+#include "list.h"
+#include "heap.h"
+#include "io.h"
+#include "mapfile.h"
+#include "search.h"
+#include "table.h"
+#include "pool.h"
+#include "parallel.h"
+#include "hda.h"
+#include "sma.h"
+#include "walking.h"
+
+#if BOARD_ROWS != 3 || BOARD_COLS != 3
+#error "The README test cases are 3x3 boards"
+#endif
+
+#define MAX_BENCH_CASES 64      //README test cases plus random instances
+#define RANDOM_WALK_LENGTH 200  //moves of the walk from the goal giving a random board
+#define RANDOM_ATTEMPTS 1000000 //random boards tried per depth before giving up
+#define MAX_BENCH_THREADS 32    //default for the most threads HDA* is measured with
+#define BENCH_SMA_MEMORY (32 << 10) //bytes of nodes of SMA*, few enough for the harder cases to forget nodes
+
+//optimal solution lengths of the random instances
+static const unsigned int randomDepths[] = { 8, 16, 20, 24, 28 };
+
+//README test cases, read row by row
+static const struct {
+    char *name;
+    char *board;
+} testCases[] = {
+    { "Easy",   "134862705" },
+    { "Medium", "281043765" },
+    { "Hard",   "281463750" },
+    { "Worst",  "567408321" }
+};
+
+static const char *goalBoard = "123804765";
+
+//this enumerates the engines under benchmark
+typedef enum BenchEngine {
+    BENCH_ASTAR, BENCH_IDASTAR, BENCH_BFS, BENCH_BIDIRECTIONAL, BENCH_PARALLEL, BENCH_TABLE, BENCH_WEIGHTED,
+    BENCH_ANYTIME, BENCH_HDA, BENCH_SMA, BENCH_ENGINES
+} BenchEngine;
+
+static const char *engineNames[BENCH_ENGINES] = { "astar", "idastar", "bfs", "bibfs", "pbfs", "table", "wastar",
+    "arastar", "hdastar", "smastar" };
+
+//this enumerates the heuristics of the engines that take one
+typedef enum BenchHeuristic {
+    BENCH_MANHATTAN, BENCH_CONFLICT, BENCH_WALKING, BENCH_HEURISTICS
+} BenchHeuristic;
+
+static const char *heuristicNames[BENCH_HEURISTICS] = { "manhattan", "conflict", "walking" };
+
+//this enumerates the output formats
+typedef enum BenchFormat {
+    FORMAT_TABLE, FORMAT_CSV, FORMAT_JSON
+} BenchFormat;
+
+/**
+ * DESCRIPTION: A board to solve and its optimal solution length.
+**/
+typedef struct BenchCase {
+    char name[32];             //name of the case in the results
+    State initial;             //the initial state
+    unsigned int depth;        //optimal solution length
+} BenchCase;
+
+/**
+ * DESCRIPTION: The measurements of one engine on one case.
+**/
+typedef struct BenchResult {
+    unsigned int threads;      //number of threads of the engine
+    unsigned int runs;         //number of times the case was solved
+    unsigned int length;       //solution length found
+    unsigned int expanded;     //nodes expanded per run
+    unsigned int generated;    //nodes generated per run
+    double meanTime;           //mean wall-clock time per run (in seconds)
+    double minTime;            //fastest run (in seconds)
+    double speedup;            //mean time of the serial A* with the Manhattan distance over `meanTime`
+    double expandedPerSec;     //nodes expanded per second over all runs
+    size_t memoryUsed;         //peak bytes held by the search
+    double allocations;        //calls to the allocation functions per run
+    long peakRss;              //peak resident set size of the process so far (in KB)
+} BenchResult;
+
+/**
+ * DESCRIPTION: This fills `state` from a row-major string of nine symbols.
+**/
+static void loadState(State * const state, char const *symbols) {
+    parseState(&symbols, state);
+}
+
+/**
+ * DESCRIPTION:
+ *    A xorshift64* generator, so that the random instances only depend on the
+ *    seed and not on the C library.
+**/
+static uint64_t nextRandom(uint64_t * const seed) {
+    *seed ^= *seed >> 12;
+    *seed ^= *seed << 25;
+    *seed ^= *seed >> 27;
+    return *seed * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * DESCRIPTION:
+ *    This generates `count` random instances of every depth in `randomDepths`,
+ *    writing no more than `capacity` cases. Random boards are taken from long
+ *    random walks from the goal, and kept when their distance in `table` is the
+ *    wanted depth.
+ * RETURN:
+ *    Returns the number of cases written to `cases`.
+**/
+static unsigned int generateCases(BenchCase *cases, unsigned int capacity, unsigned int count, uint64_t seed,
+        DistanceTable const *table) {
+    unsigned int caseCount = 0;
+    unsigned int d, i, step, attempt;
+    State state;
+    Move move;
+
+    for(d = 0; d < sizeof(randomDepths) / sizeof(randomDepths[0]); ++d) {
+        for(i = 0, attempt = 0; i < count && caseCount < capacity && attempt < RANDOM_ATTEMPTS; ++attempt) {
+            state = table->goal;
+            for(step = 0; step < RANDOM_WALK_LENGTH; ) {
+                move = nextRandom(&seed) % 4;
+                if(createState(&state, move, &state))
+                    ++step;
+            }
+
+            if(readDistance(table, &state) != randomDepths[d])
+                continue;
+
+            state.action = NOT_APPLICABLE;
+            cases[caseCount].initial = state;
+            cases[caseCount].depth = randomDepths[d];
+            snprintf(cases[caseCount].name, sizeof(cases[caseCount].name), "Random%u-%u", randomDepths[d], i + 1);
+            ++caseCount;
+            ++i;
+        }
+    }
+
+    return caseCount;
+}
+
+/**
+ * DESCRIPTION: This reads the peak resident set size of the process, in KB.
+**/
+static long readPeakRss(void) {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+
+    if(getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; //reported in bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+//the anytime A* runs until its solution is proven optimal
+static const AnytimeOptions anytimeOptions = { ANYTIME_WEIGHT, ANYTIME_WEIGHT_STEP, 0, NULL, NULL };
+
+/**
+ * DESCRIPTION: This determines whether `engine` is guided by a heuristic.
+**/
+static char usesHeuristic(BenchEngine engine) {
+    return engine == BENCH_ASTAR || engine == BENCH_IDASTAR || engine == BENCH_WEIGHTED || engine == BENCH_ANYTIME
+        || engine == BENCH_HDA || engine == BENCH_SMA;
+}
+
+/**
+ * DESCRIPTION:
+ *    This solves `initial` once with `engine`, guided by `heuristic` if it takes
+ *    one; HDA* runs `threadCount` threads.
+**/
+static SolutionPath* runEngine(BenchEngine engine, SearchContext * const context, ThreadPool * const pool,
+        DistanceTable const *table, Heuristic const *heuristic, unsigned int threadCount, State *initial, State *goal) {
+    switch(engine) {
+        case BENCH_IDASTAR:
+            return IDAStar_search(context, initial, goal, heuristic);
+        case BENCH_BFS:
+            return BFS_search(context, initial, goal);
+        case BENCH_BIDIRECTIONAL:
+            return BidirectionalBFS_search(context, initial, goal);
+        case BENCH_PARALLEL:
+            return ParallelBFS_search(context, pool, initial, goal);
+        case BENCH_TABLE:
+            return Table_search(context, table, initial, goal);
+        case BENCH_WEIGHTED:
+            return WeightedAStar_search(context, initial, goal, heuristic, ANYTIME_WEIGHT);
+        case BENCH_ANYTIME:
+            return AnytimeAStar_search(context, initial, goal, heuristic, &anytimeOptions);
+        case BENCH_HDA:
+            return HDAStar_search(context, initial, goal, heuristic, threadCount);
+        case BENCH_SMA:
+            return SMAStar_search(context, initial, goal, heuristic, BENCH_SMA_MEMORY);
+        default:
+            return AStar_search(context, initial, goal, heuristic);
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This solves `benchCase` repeatedly with `engine`, at least `minRuns` times
+ *    and until `minTime` seconds have been accumulated, and measures the runs.
+**/
+static void measureCase(BenchEngine engine, SearchContext * const context, ThreadPool * const pool,
+        DistanceTable const *table, Heuristic const *heuristic, unsigned int threadCount, BenchCase * const benchCase,
+        State *goal, unsigned int minRuns, double minTime, BenchResult * const result) {
+    SolutionPath *path;
+    unsigned long allocationsBefore = allocationCount;
+    unsigned long totalExpanded = 0;
+    double start, elapsed, totalTime = 0;
+
+    memset(result, 0, sizeof(BenchResult));
+    result->minTime = -1;
+
+    do {
+        start = readClock();
+        path = runEngine(engine, context, pool, table, heuristic, threadCount, &benchCase->initial, goal);
+        destroySolution(&path);
+        elapsed = readClock() - start;
+
+        totalTime += elapsed;
+        totalExpanded += context->stats.nodesExpanded;
+        if(result->minTime < 0 || elapsed < result->minTime)
+            result->minTime = elapsed;
+        ++result->runs;
+    } while(result->runs < minRuns || totalTime < minTime);
+
+    result->threads = engine == BENCH_PARALLEL? pool->workerCount : threadCount;
+    result->length = context->stats.solutionLength;
+    result->expanded = context->stats.nodesExpanded;
+    result->generated = context->stats.nodesGenerated;
+    result->meanTime = totalTime / result->runs;
+    result->expandedPerSec = totalTime > 0? totalExpanded / totalTime : 0;
+    result->memoryUsed = context->stats.memoryUsed;
+    result->allocations = (double)(allocationCount - allocationsBefore) / result->runs;
+    result->peakRss = readPeakRss();
+}
+
+/**
+ * DESCRIPTION: This writes the header of the results.
+**/
+static void printHeader(BenchFormat format) {
+    if(format == FORMAT_CSV)
+        printf("engine,heuristic,threads,case,depth,length,runs,expanded,generated,mean_ms,min_ms,speedup,"
+            "expanded_per_sec,memory_bytes,allocations,peak_rss_kb\n");
+    else if(format == FORMAT_JSON)
+        printf("[");
+    else
+        printf("%-8s %-10s %7s %-12s %5s %6s %6s %10s %10s %10s %10s %7s %14s %12s %8s %10s\n", "engine", "heuristic",
+            "threads", "case", "depth", "length", "runs", "expanded", "generated", "mean (ms)", "min (ms)", "speedup",
+            "expanded/sec", "memory (B)", "allocs", "rss (KB)");
+}
+
+/**
+ * DESCRIPTION:
+ *    This writes the result of `engine` guided by `heuristic` on `benchCase`;
+ *    `heuristic` is "-" for the engines that take none.
+**/
+static void printResult(BenchFormat format, char isFirst, BenchEngine engine, char const *heuristic,
+        BenchCase const *benchCase, BenchResult const *result) {
+    if(format == FORMAT_CSV) {
+        printf("%s,%s,%u,%s,%u,%u,%u,%u,%u,%.6f,%.6f,%.3f,%.0f,%lu,%.1f,%ld\n", engineNames[engine], heuristic,
+            result->threads, benchCase->name, benchCase->depth, result->length, result->runs, result->expanded,
+            result->generated, result->meanTime * 1000, result->minTime * 1000, result->speedup, result->expandedPerSec,
+            (unsigned long)result->memoryUsed, result->allocations, result->peakRss);
+    }
+    else if(format == FORMAT_JSON) {
+        printf("%s\n  {\"engine\": \"%s\", \"heuristic\": \"%s\", \"threads\": %u, \"case\": \"%s\", \"depth\": %u, "
+            "\"length\": %u, \"runs\": %u, \"expanded\": %u, \"generated\": %u, \"mean_ms\": %.6f, \"min_ms\": %.6f, "
+            "\"speedup\": %.3f, \"expanded_per_sec\": %.0f, \"memory_bytes\": %lu, \"allocations\": %.1f, "
+            "\"peak_rss_kb\": %ld}", isFirst? "" : ",", engineNames[engine], heuristic, result->threads,
+            benchCase->name, benchCase->depth, result->length, result->runs, result->expanded, result->generated,
+            result->meanTime * 1000, result->minTime * 1000, result->speedup, result->expandedPerSec,
+            (unsigned long)result->memoryUsed, result->allocations, result->peakRss);
+    }
+    else {
+        printf("%-8s %-10s %7u %-12s %5u %6u %6u %10u %10u %10.4f %10.4f %7.2f %14.0f %12lu %8.1f %10ld\n",
+            engineNames[engine], heuristic, result->threads, benchCase->name, benchCase->depth, result->length,
+            result->runs, result->expanded, result->generated, result->meanTime * 1000, result->minTime * 1000,
+            result->speedup, result->expandedPerSec, (unsigned long)result->memoryUsed, result->allocations,
+            result->peakRss);
+    }
+}
+
+int main(int argc, char **argv) {
+    BenchCase cases[MAX_BENCH_CASES];
+    BenchResult result;
+    BenchFormat format = FORMAT_TABLE;
+    State goalState;
+    SearchContext context;
+    ThreadPool pool;
+    DistanceTable table;
+    ConflictTable conflicts;
+    WalkingDistance walking;
+    Heuristic conflictHeuristic, walkingHeuristic;
+    Heuristic const *heuristics[BENCH_HEURISTICS] = { NULL, &conflictHeuristic, &walkingHeuristic }; //NULL for Manhattan
+    uint64_t seed = 1;
+    unsigned int randomCount = 3;  //random instances per depth
+    unsigned int minRuns = 3;      //minimum number of runs per case
+    double minTime = 0.2;          //minimum accumulated time per case (in seconds)
+    unsigned int maxThreads = MAX_BENCH_THREADS; //HDA* is measured with 1, 2, 4, ... up to this many threads
+    unsigned int caseCount = 0, engine, heuristic, threads, i;
+    double serialTime[MAX_BENCH_CASES];       //mean time of the serial A* on each case, for the speedups
+    char isFirst = 1;
+
+    for(i = 1; i < (unsigned int)argc; ++i) {
+        if(!strcmp(argv[i], "--format") && i + 1 < (unsigned int)argc) {
+            ++i;
+            format = !strcmp(argv[i], "csv")? FORMAT_CSV : !strcmp(argv[i], "json")? FORMAT_JSON : FORMAT_TABLE;
+        }
+        else if(!strcmp(argv[i], "--seed") && i + 1 < (unsigned int)argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if(!strcmp(argv[i], "--count") && i + 1 < (unsigned int)argc) {
+            randomCount = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--runs") && i + 1 < (unsigned int)argc) {
+            minRuns = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--time") && i + 1 < (unsigned int)argc) {
+            minTime = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--threads") && i + 1 < (unsigned int)argc) {
+            maxThreads = atoi(argv[++i]);
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--format table|csv|json] [--seed N] [--count N] [--runs N] "
+                "[--time SECONDS] [--threads N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    //a zero seed would leave the generator stuck at zero
+    if(!seed)
+        seed = 1;
+
+    loadState(&goalState, goalBoard);
+    initSearchContext(&context);
+
+    //the distance table gives the depth of every case, and is an engine itself
+    if(!buildDistanceTable(&table, &goalState) || !buildConflictTable(&goalState, &conflicts)
+            || !buildWalkingDistance(&goalState, &walking) || !createPool(&pool, countProcessors())) {
+        fprintf(stderr, "ERROR: Not enough memory to set up the benchmark.\n");
+        return 1;
+    }
+
+    for(i = 0; i < sizeof(testCases) / sizeof(testCases[0]); ++i, ++caseCount) {
+        strcpy(cases[caseCount].name, testCases[i].name);
+        loadState(&cases[caseCount].initial, testCases[i].board);
+        cases[caseCount].depth = readDistance(&table, &cases[caseCount].initial);
+    }
+    caseCount += generateCases(cases + caseCount, MAX_BENCH_CASES - caseCount, randomCount, seed, &table);
+
+    useConflicts(&conflictHeuristic, &conflicts);
+    useWalking(&walkingHeuristic, &walking);
+
+    printHeader(format);
+
+    //HDA* is guided by the Manhattan distance only, its rows measuring how it scales
+    for(engine = 0; engine < BENCH_ENGINES; ++engine) {
+        for(heuristic = 0; heuristic < (usesHeuristic(engine) && engine != BENCH_HDA? BENCH_HEURISTICS : 1); ++heuristic) {
+            for(threads = 1; threads <= (engine == BENCH_HDA? maxThreads : 1); threads *= 2) {
+                for(i = 0; i < caseCount; ++i) {
+                    measureCase(engine, &context, &pool, &table, heuristics[heuristic], threads, &cases[i], &goalState,
+                        minRuns, minTime, &result);
+
+                    //the serial A* with the Manhattan distance is measured first, and is the baseline
+                    if(engine == BENCH_ASTAR && heuristic == BENCH_MANHATTAN)
+                        serialTime[i] = result.meanTime;
+                    result.speedup = result.meanTime > 0? serialTime[i] / result.meanTime : 0;
+
+                    printResult(format, isFirst, engine, usesHeuristic(engine)? heuristicNames[heuristic] : "-",
+                        &cases[i], &result);
+                    isFirst = 0;
+                    fflush(stdout);
+                }
+            }
+        }
+    }
+
+    if(format == FORMAT_JSON)
+        printf("\n]\n");
+
+    destroyPool(&pool);
+    destroyDistanceTable(&table);
+    destroyWalkingDistance(&walking);
+    destroySearchContext(&context);
+    return 0;
+}
@@ -0,0 +1,286 @@
+#define CACHE_MOVE_BYTES (MAX_SOLUTION_LENGTH / 4) //bytes of the moves of an entry, 2 bits per move
+
+/**
+ * DESCRIPTION:
+ *    A solution remembered by the cache. Its key is the initial board relabelled
+ *    by `relabelState()` and mapped by `canonicalState()`, along with the blank
+ *    cell of the goal, which together name the instance up to the names of its
+ *    tiles and the symmetries of the board.
+**/
+typedef struct CacheEntry {
+    Board board;               //the relabelled and mapped initial board
+    unsigned char goalBlank;   //the blank cell of the goal
+    unsigned char isReferenced; //set when the entry is used; cleared as the clock hand passes
+    unsigned short length;     //number of moves of the solution
+    unsigned char moves[CACHE_MOVE_BYTES]; //the moves solving `board`, 4 per byte from the lowest bits
+} CacheEntry;
+
+/**
+ * DESCRIPTION:
+ *    A bounded cache of solutions, shared by the threads that solve a batch. It
+ *    holds at most `capacity` entries and, once full, evicts them in CLOCK
+ *    order: the hand sweeps the entries, sparing and clearing those used since
+ *    it last passed, and replaces the first that was not. Entries are found
+ *    through an open-addressing index of twice their number.
+ *
+ *    Boards are mapped to the least of their images under the symmetries of the
+ *    canonical goal of their blank cell, so that an instance and its rotations
+ *    and reflections share one entry; its moves are carried back on lookup.
+**/
+typedef struct SolutionCache {
+    CacheEntry *entries;       //the entries, filled in order until full
+    uint32_t *index;           //slots holding 1 + the position of an entry; 0 if empty
+    size_t capacity;           //the most entries held
+    size_t count;              //the entries held
+    size_t indexMask;          //the number of slots of `index`, minus 1
+    size_t hand;               //the entry the clock hand points to
+    SymmetryGroup symmetries[MAX_BOARD_SIZE]; //the symmetries of the canonical goal of each blank cell
+    unsigned long hits;        //lookups that found their solution
+    unsigned long misses;      //lookups that did not
+    pthread_mutex_t lock;      //guards the fields above
+} SolutionCache;
+
+/**
+ * DESCRIPTION: This allocates an empty cache of `capacity` entries.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char createSolutionCache(SolutionCache * const cache, size_t capacity) {
+    State goal;
+    size_t slots = 1;
+    unsigned int blank, cell;
+
+    if(!capacity || capacity >= UINT32_MAX)
+        return 0;
+    while(slots < 2 * capacity)
+        slots *= 2;
+
+    cache->entries = malloc(capacity * sizeof(CacheEntry));
+    cache->index = calloc(slots, sizeof(uint32_t));
+    if(!cache->entries || !cache->index) {
+        free(cache->entries);
+        free(cache->index);
+        return 0;
+    }
+
+    cache->capacity = capacity;
+    cache->count = 0;
+    cache->indexMask = slots - 1;
+    cache->hand = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+
+    //the canonical goal of each blank cell numbers its tiles 1, 2, ... in row-major order
+    for(blank = 0; blank < BOARD_SIZE; ++blank) {
+        goal.board = 0;
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            if(cell != blank)
+                goal.board |= (Board)(cell < blank? cell + 1 : cell) << (TILE_BITS * cell);
+        }
+        goal.blank = blank;
+        buildSymmetryGroup(&goal, &cache->symmetries[blank]);
+    }
+    pthread_mutex_init(&cache->lock, NULL);
+    return 1;
+}
+
+/**
+ * DESCRIPTION: This deallocates the entries of the cache.
+**/
+void destroySolutionCache(SolutionCache * const cache) {
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->entries);
+    free(cache->index);
+    cache->entries = NULL;
+    cache->index = NULL;
+    cache->capacity = 0;
+    cache->count = 0;
+}
+
+/**
+ * DESCRIPTION: This finds the home slot of a key in the index.
+**/
+static inline size_t homeSlot(SolutionCache const *cache, Board board, unsigned char goalBlank) {
+    return (hashBoard(board) ^ goalBlank * 0x9E3779B97F4A7C15ull) & cache->indexMask;
+}
+
+/**
+ * DESCRIPTION: This finds the slot of a key in the index, or the empty slot where it belongs.
+**/
+size_t findCacheSlot(SolutionCache const *cache, Board board, unsigned char goalBlank) {
+    size_t i = homeSlot(cache, board, goalBlank);
+    CacheEntry const *entry;
+
+    while(cache->index[i]) {
+        entry = &cache->entries[cache->index[i] - 1];
+        if(entry->board == board && entry->goalBlank == goalBlank)
+            break;
+        i = (i + 1) & cache->indexMask;
+    }
+    return i;
+}
+
+/**
+ * DESCRIPTION:
+ *    This empties slot `i` of the index, moving the entries after it back so that
+ *    none is left past an empty slot from its home slot.
+**/
+void removeCacheSlot(SolutionCache * const cache, size_t i) {
+    size_t j = i, home;
+    CacheEntry const *entry;
+
+    for(;;) {
+        j = (j + 1) & cache->indexMask;
+        if(!cache->index[j])
+            break;
+
+        //an entry may fill the hole unless its home slot lies after the hole, up to it
+        entry = &cache->entries[cache->index[j] - 1];
+        home = homeSlot(cache, entry->board, entry->goalBlank);
+        if(((j - home) & cache->indexMask) >= ((j - i) & cache->indexMask)) {
+            cache->index[i] = cache->index[j];
+            i = j;
+        }
+    }
+    cache->index[i] = 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This looks up the solution of `initial` for `goal`, and counts the lookup
+ *    as a hit or a miss.
+ * PARAMETERS:
+ *    cache   - the cache to look into
+ *    initial - the initial state
+ *    goal    - the goal state
+ *    moves   - where the moves of the solution are written to; room for
+ *              MAX_SOLUTION_LENGTH moves
+ *    stats   - where the hits and misses of the cache so far are written to
+ * RETURN:
+ *    Returns the number of moves written; -1 if the solution is not cached.
+**/
+int lookupSolution(SolutionCache * const cache, State const *initial, State const *goal, Move * const moves,
+        SearchStats * const stats) {
+    State relabelled, canonical;
+    Symmetry const *symmetry;
+    CacheEntry *entry;
+    size_t slot;
+    int length = -1, i;
+
+    relabelState(initial, goal, &relabelled);
+    symmetry = &cache->symmetries[goal->blank].symmetries[
+        canonicalState(&cache->symmetries[goal->blank], &relabelled, &canonical)];
+    pthread_mutex_lock(&cache->lock);
+
+    slot = findCacheSlot(cache, canonical.board, goal->blank);
+    if(cache->index[slot]) {
+        entry = &cache->entries[cache->index[slot] - 1];
+        entry->isReferenced = 1;
+        length = entry->length;
+        for(i = 0; i < length; ++i) {
+            moves[i] = symmetry->inverse[(entry->moves[i / 4] >> (2 * (i % 4))) & 3];
+        }
+        ++cache->hits;
+    }
+    else {
+        ++cache->misses;
+    }
+
+    stats->cacheHits = cache->hits;
+    stats->cacheMisses = cache->misses;
+    pthread_mutex_unlock(&cache->lock);
+    return length;
+}
+
+/**
+ * DESCRIPTION:
+ *    This remembers `path` as the solution of `initial` for `goal`, evicting an
+ *    entry if the cache is full. Solutions longer than MAX_SOLUTION_LENGTH are
+ *    not cached.
+ * PARAMETERS:
+ *    cache   - the cache to store into
+ *    initial - the initial state
+ *    goal    - the goal state
+ *    path    - the solution returned by a search, its first node being the
+ *              initial state
+ *    length  - the number of moves of `path`
+**/
+void storeSolution(SolutionCache * const cache, State const *initial, State const *goal, SolutionPath const *path,
+        unsigned int length) {
+    State relabelled, canonical;
+    Symmetry const *symmetry;
+    CacheEntry *entry;
+    size_t slot, position;
+    unsigned int i;
+
+    if(length > MAX_SOLUTION_LENGTH)
+        return;
+
+    relabelState(initial, goal, &relabelled);
+    symmetry = &cache->symmetries[goal->blank].symmetries[
+        canonicalState(&cache->symmetries[goal->blank], &relabelled, &canonical)];
+    pthread_mutex_lock(&cache->lock);
+
+    slot = findCacheSlot(cache, canonical.board, goal->blank);
+    if(cache->index[slot]) {
+        pthread_mutex_unlock(&cache->lock);
+        return;
+    }
+
+    if(cache->count < cache->capacity) {
+        position = cache->count++;
+    }
+    else {
+        //sweep the hand past the entries used since it last passed
+        while(cache->entries[cache->hand].isReferenced) {
+            cache->entries[cache->hand].isReferenced = 0;
+            cache->hand = (cache->hand + 1) % cache->capacity;
+        }
+        position = cache->hand;
+        cache->hand = (cache->hand + 1) % cache->capacity;
+
+        entry = &cache->entries[position];
+        removeCacheSlot(cache, findCacheSlot(cache, entry->board, entry->goalBlank));
+        slot = findCacheSlot(cache, canonical.board, goal->blank);
+    }
+
+    entry = &cache->entries[position];
+    entry->board = canonical.board;
+    entry->goalBlank = goal->blank;
+    entry->isReferenced = 0;
+    entry->length = length;
+    memset(entry->moves, 0, sizeof(entry->moves));
+
+    //skip the first node, which holds the initial state
+    for(i = 0, path = path->next; path && i < length; ++i, path = path->next) {
+        entry->moves[i / 4] |= symmetry->move[path->action] << (2 * (i % 4));
+    }
+    cache->index[slot] = position + 1;
+
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * DESCRIPTION:
+ *    The cached "search". It returns the solution of `initial` for `goal` from
+ *    the cache, or of an earlier instance that only differs in the names of its
+ *    tiles or by a symmetry, recording it in `context` as a search of no expansion.
+ * RETURN:
+ *    Returns the solution; NULL if it is not cached.
+**/
+SolutionPath* Cache_search(SearchContext * const context, SolutionCache * const cache, State const *initial,
+        State const *goal) {
+    Move moves[MAX_SOLUTION_LENGTH];
+    int length;
+
+    beginSearch(context);
+    double start = readClock();
+
+    length = lookupSolution(cache, initial, goal, moves, &context->stats);
+    if(length < 0)
+        return NULL;
+
+    context->stats.solutionLength = length;
+    context->stats.runtime = readClock() - start;
+    return createSolution(moves, length);
+}
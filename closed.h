@@ -0,0 +1,298 @@
+#define DENSE_RANK_LIMIT 9             //boards with at most this many cells are ranked densely
+#define UNVISITED_DEPTH 0xFF           //depth recorded for boards that were never reached
+#define MAX_PATH_COST (UNVISITED_DEPTH - 1) //the longest path cost a node or a closed set can record
+#define INITIAL_CLOSED_CAPACITY 65536  //number of slots of a new hashed closed set
+
+/**
+ * DESCRIPTION:
+ *    This takes `bytes` out of the memory budget of a search before one of its
+ *    structures grows by that much.
+ * PARAMETERS:
+ *    budget - the bytes the search may still allocate; NULL for no limit
+ *    bytes  - the bytes about to be allocated
+ * RETURN:
+ *    Returns 1 if `bytes` fit in the budget, 0 otherwise.
+**/
+char chargeMemory(size_t *budget, size_t bytes) {
+    if(!budget)
+        return 1;
+    if(bytes > *budget)
+        return 0;
+
+    *budget -= bytes;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This ranks the board of `state` in the factorial number system (Lehmer code),
+ *    i.e. the number of boards preceding it in lexicographic order. The rank only
+ *    fits in 64 bits for boards of at most 20 cells.
+ * PARAMETER:
+ *    state - the state whose board is to be ranked
+ * RETURN:
+ *    Returns an integer in [0, BOARD_SIZE!).
+**/
+uint64_t rankState(State const *state) {
+    uint64_t rank = 0;
+    unsigned int used = 0; //bit `n` is set once symbol `n` has been ranked
+    unsigned int symbol, i;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        symbol = getTile(state->board, i);
+
+        //count the symbols less than `symbol` which are not yet placed
+        rank = rank * (BOARD_SIZE - i) + symbol - __builtin_popcount(used & ((1u << symbol) - 1));
+        used |= 1u << symbol;
+    }
+
+    return rank;
+}
+
+#if BOARD_SIZE <= DENSE_RANK_LIMIT
+
+//BOARD_SIZE!, the number of arrangements of a board small enough to be ranked densely
+#define BOARD_PERMUTATIONS (BOARD_SIZE == 9? 362880 : BOARD_SIZE == 8? 40320 : BOARD_SIZE == 6? 720 : 24)
+
+/**
+ * DESCRIPTION:
+ *    The closed set shared by the search engines for duplicate detection. Every
+ *    board is ranked to a dense index in [0, BOARD_SIZE!), and the lowest path cost
+ *    it has been reached with is recorded in `depth` at that index.
+**/
+typedef struct ClosedSet {
+    unsigned char depth[BOARD_PERMUTATIONS]; //best known path cost of each board
+} ClosedSet;
+
+/**
+ * DESCRIPTION:
+ *    This allocates a closed set in which no board has been visited yet.
+ * PARAMETERS:
+ *    budget - the bytes the search may still allocate, charged for the set; NULL
+ *             for no limit
+ * RETURN:
+ *    Returns a pointer to the new closed set, or NULL on failure.
+**/
+ClosedSet* createClosedSet(size_t *budget) {
+    ClosedSet *set = chargeMemory(budget, sizeof(ClosedSet))? malloc(sizeof(ClosedSet)) : NULL;
+    if(set)
+        memset(set->depth, UNVISITED_DEPTH, sizeof(set->depth));
+    return set;
+}
+
+/**
+ * DESCRIPTION:
+ *    This finds the recorded path cost of `state`.
+ * RETURN:
+ *    Returns a pointer to the path cost, or NULL on failure.
+**/
+unsigned char* findClosedDepth(ClosedSet *set, State const *state) {
+    return &set->depth[rankState(state)];
+}
+
+/**
+ * DESCRIPTION: This reads the recorded path cost of `state`.
+**/
+unsigned char readClosedDepth(ClosedSet const *set, State const *state) {
+    return set->depth[rankState(state)];
+}
+
+/**
+ * DESCRIPTION: This returns the number of bytes allocated for `set`.
+**/
+size_t closedSetBytes(ClosedSet const *set) {
+    (void)set;
+    return sizeof(ClosedSet);
+}
+
+/**
+ * DESCRIPTION: This marks every board of `set` as unvisited again.
+**/
+void clearClosedSet(ClosedSet * const set) {
+    memset(set->depth, UNVISITED_DEPTH, sizeof(set->depth));
+}
+
+/**
+ * DESCRIPTION: This frees memory of `set` and is reassigned to NULL
+**/
+void destroyClosedSet(ClosedSet **set) {
+    free(*set);
+    *set = NULL;
+}
+
+#else
+
+/**
+ * DESCRIPTION:
+ *    A slot of the hashed closed set. Since every symbol of a board is distinct,
+ *    a board of all zeroes never occurs and marks an empty slot.
+**/
+typedef struct ClosedEntry {
+    Board board;               //the board reached
+    unsigned char depth;       //best known path cost of `board`
+} ClosedEntry;
+
+/**
+ * DESCRIPTION:
+ *    The closed set shared by the search engines for duplicate detection. Boards
+ *    too large to be ranked densely are kept in an open-addressing hash table,
+ *    which is doubled whenever it becomes half full.
+**/
+typedef struct ClosedSet {
+    ClosedEntry *entries;      //the hash table
+    size_t capacity;           //number of slots in `entries`, a power of 2
+    size_t count;              //number of occupied slots
+    size_t *budget;            //the bytes the search may still allocate, charged as the
+                               //table grows; NULL for no limit
+} ClosedSet;
+
+/**
+ * DESCRIPTION:
+ *    This allocates a closed set in which no board has been visited yet.
+ * PARAMETERS:
+ *    budget - the bytes the search may still allocate, charged for the set and
+ *             whenever it grows; NULL for no limit
+ * RETURN:
+ *    Returns a pointer to the new closed set, or NULL on failure.
+**/
+ClosedSet* createClosedSet(size_t *budget) {
+    ClosedSet *set;
+
+    if(!chargeMemory(budget, sizeof(ClosedSet) + INITIAL_CLOSED_CAPACITY * sizeof(ClosedEntry)))
+        return NULL;
+    set = malloc(sizeof(ClosedSet));
+    if(!set)
+        return NULL;
+
+    set->capacity = INITIAL_CLOSED_CAPACITY;
+    set->count = 0;
+    set->budget = budget;
+    set->entries = calloc(set->capacity, sizeof(ClosedEntry));
+    if(!set->entries) {
+        free(set);
+        return NULL;
+    }
+    return set;
+}
+
+/**
+ * DESCRIPTION:
+ *    This finds the slot of `board` in `entries`, or the empty slot where it
+ *    belongs.
+**/
+ClosedEntry* probeClosedSet(ClosedEntry *entries, size_t capacity, Board board) {
+    size_t i = hashBoard(board) & (capacity - 1);
+
+    while(entries[i].board && entries[i].board != board) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &entries[i];
+}
+
+/**
+ * DESCRIPTION:
+ *    This finds the recorded path cost of `state`, inserting the state as
+ *    unvisited if it is not in the set yet.
+ * RETURN:
+ *    Returns a pointer to the path cost, or NULL if the set cannot grow within
+ *    its memory budget or memory runs out.
+**/
+unsigned char* findClosedDepth(ClosedSet *set, State const *state) {
+    ClosedEntry *entry;
+    size_t i;
+
+    //double the table before it gets too full for probing to be fast
+    if(2 * (set->count + 1) > set->capacity) {
+        if(!chargeMemory(set->budget, set->capacity * sizeof(ClosedEntry)))
+            return NULL;
+
+        ClosedEntry *entries = calloc(2 * set->capacity, sizeof(ClosedEntry));
+        if(!entries)
+            return NULL;
+
+        for(i = 0; i < set->capacity; ++i) {
+            if(set->entries[i].board)
+                *probeClosedSet(entries, 2 * set->capacity, set->entries[i].board) = set->entries[i];
+        }
+
+        free(set->entries);
+        set->entries = entries;
+        set->capacity *= 2;
+    }
+
+    entry = probeClosedSet(set->entries, set->capacity, state->board);
+    if(!entry->board) {
+        entry->board = state->board;
+        entry->depth = UNVISITED_DEPTH;
+        ++set->count;
+    }
+    return &entry->depth;
+}
+
+/**
+ * DESCRIPTION:
+ *    This reads the recorded path cost of `state`. Unlike `findClosedDepth()`,
+ *    a state that is not in the set is left out of it.
+ * RETURN:
+ *    Returns the path cost; UNVISITED_DEPTH if `state` was never reached.
+**/
+unsigned char readClosedDepth(ClosedSet const *set, State const *state) {
+    ClosedEntry const *entry = probeClosedSet(set->entries, set->capacity, state->board);
+
+    return entry->board? entry->depth : UNVISITED_DEPTH;
+}
+
+/**
+ * DESCRIPTION: This returns the number of bytes allocated for `set`.
+**/
+size_t closedSetBytes(ClosedSet const *set) {
+    return sizeof(ClosedSet) + set->capacity * sizeof(ClosedEntry);
+}
+
+/**
+ * DESCRIPTION:
+ *    This empties `set`. Its table keeps the capacity it has grown to.
+**/
+void clearClosedSet(ClosedSet * const set) {
+    memset(set->entries, 0, set->capacity * sizeof(ClosedEntry));
+    set->count = 0;
+}
+
+/**
+ * DESCRIPTION: This frees memory of `set` and is reassigned to NULL
+**/
+void destroyClosedSet(ClosedSet **set) {
+    if(*set)
+        free((*set)->entries);
+    free(*set);
+    *set = NULL;
+}
+
+#endif
+
+/**
+ * DESCRIPTION:
+ *    This records that `state` has been reached with a path cost of `depth`,
+ *    unless it was already reached with an equal or lower cost. A state is thus
+ *    only reopened when a strictly better path to it is found.
+ * PARAMETERS:
+ *    set   - the closed set to update; NULL disables duplicate detection
+ *    state - the state that has been reached
+ *    depth - the path cost `state` has been reached with
+ * RETURN:
+ *    Returns 1 if `state` is new or improved and must be explored, 0 otherwise;
+ *    -1 if the set cannot grow to hold it, within its budget or at all.
+**/
+int updateClosedSet(ClosedSet *set, State const *state, unsigned int depth) {
+    if(!set)
+        return 1;
+
+    PROFILE_BEGIN(PHASE_DUPLICATE_CHECK);
+    unsigned char *known = findClosedDepth(set, state);
+    int isImproved = !known? -1 : depth < *known;
+
+    if(isImproved > 0)
+        *known = depth;
+    PROFILE_END(PHASE_DUPLICATE_CHECK);
+    return isImproved;
+}
@@ -0,0 +1,109 @@
+/**
+ * DESCRIPTION:
+ *    The statistics of a single search, written by the search engines and read
+ *    by the output functions.
+**/
+typedef struct SearchStats {
+    unsigned int nodesExpanded;  //number of expanded nodes
+    unsigned int nodesGenerated; //number of generated nodes
+    unsigned int solutionLength; //number of moves in solution
+    size_t memoryUsed;           //peak bytes held by the search, closed set included
+    unsigned int levelsExpanded; //number of levels expanded by the level-synchronous BFS
+    double bound;                //proven ratio of the solution length to the optimum, by
+                                 //the anytime A*; 0 if not known
+    double runtime;              //elapsed time (in seconds)
+    unsigned long cacheHits;     //lookups of the solution cache that found their solution
+    unsigned long cacheMisses;   //and that did not, so far; 0 without a cache
+    char isUnsolvable;           //set when the goal state is unreachable
+    char isOutOfMemory;          //set when the search gave up for lack of memory
+    char isTooDeep;              //set when paths were cut at the longest cost the search records
+} SearchStats;
+
+/**
+ * DESCRIPTION:
+ *    Everything a search mutates besides its own locals: its statistics, the
+ *    closed set it records the boards it reaches in, and the memory budget its
+ *    open list and closed set grow within. Each thread owns a context, so
+ *    searches on different contexts can run concurrently. The closed set is
+ *    kept between searches, so that a thread solving many instances does not go
+ *    back to the system allocator for each one.
+**/
+typedef struct SearchContext {
+    SearchStats stats;   //statistics of the last search
+    ClosedSet *closed;   //the closed set, allocated by the first search that needs it
+    size_t memoryLimit;  //the bytes a search may hold in its open list and closed set;
+                         //0 for no limit
+    size_t memoryLeft;   //the bytes the running search may still allocate
+    PROFILE_MEMBER       //the profile of the last search, with -DENABLE_PROFILING
+} SearchContext;
+
+/**
+ * DESCRIPTION:
+ *    This initializes `context` to hold no memory, with no limit on the memory
+ *    of its searches.
+**/
+void initSearchContext(SearchContext * const context) {
+    memset(&context->stats, 0, sizeof(context->stats));
+    context->closed = NULL;
+    context->memoryLimit = 0;
+    context->memoryLeft = SIZE_MAX;
+}
+
+/**
+ * DESCRIPTION:
+ *    This is called by every search when it starts. The statistics are reset,
+ *    and the whole memory budget is left to the search.
+**/
+void beginSearch(SearchContext * const context) {
+    memset(&context->stats, 0, sizeof(context->stats));
+    context->memoryLeft = context->memoryLimit? context->memoryLimit : SIZE_MAX;
+    PROFILE_START(context);
+}
+
+/**
+ * DESCRIPTION:
+ *    This hands out the closed set of `context`, with no board visited yet. The
+ *    bytes it holds are charged to the memory budget of the search, and its
+ *    growth is charged as it happens.
+ * RETURN:
+ *    Returns the closed set, or NULL if it does not fit in the budget or memory
+ *    runs out, which is recorded in the statistics of `context`.
+**/
+ClosedSet* acquireClosedSet(SearchContext * const context) {
+    if(context->closed && !chargeMemory(&context->memoryLeft, closedSetBytes(context->closed))) {
+        context->stats.isOutOfMemory = 1;
+        return NULL;
+    }
+
+    if(context->closed)
+        clearClosedSet(context->closed);
+    else
+        context->closed = createClosedSet(&context->memoryLeft);
+
+    if(!context->closed)
+        context->stats.isOutOfMemory = 1;
+    return context->closed;
+}
+
+/**
+ * DESCRIPTION: This releases every allocation held by `context`.
+**/
+void destroySearchContext(SearchContext * const context) {
+    PROFILE_STOP(context);
+    destroyClosedSet(&context->closed);
+}
+
+/**
+ * DESCRIPTION:
+ *    This reads a monotonic wall clock. Unlike `clock()`, which adds up the
+ *    processor time of every thread, it measures a single search correctly while
+ *    others run.
+ * RETURN:
+ *    Returns the time in seconds since an arbitrary point.
+**/
+double readClock(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
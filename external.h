@@ -0,0 +1,540 @@
+#define EXTERNAL_BUFFER_SIZE (1 << 18)                  //bytes of the stdio buffer of every file streamed
+#define EXTERNAL_MERGE_WAYS 64                          //most sorted runs merged in one pass
+#define DEFAULT_EXTERNAL_MEMORY ((size_t)256 << 20)     //bytes of boards sorted in memory at once by default
+#define MAX_EXTERNAL_LEVELS UNVISITED_DEPTH             //number of levels an enumeration may reach
+
+/**
+ * DESCRIPTION: Where and with how much memory a search on disk runs.
+**/
+typedef struct ExternalOptions {
+    char const *directory;     //the directory the level and run files are written to
+    size_t memoryBudget;       //bytes of boards sorted in memory at once
+} ExternalOptions;
+
+/**
+ * DESCRIPTION:
+ *    The function called on every board of a level once the level is complete.
+ * RETURN:
+ *    Returns 1 to go on, 0 to abort the enumeration.
+**/
+typedef char (*LevelVisitor)(void *data, Board board, unsigned int level);
+
+/**
+ * DESCRIPTION:
+ *    A breadth-first enumeration of the boards reachable from a goal, kept on
+ *    disk rather than in memory. Each level is a file of packed boards, sorted
+ *    and free of duplicates. The successors of a level are gathered in memory
+ *    up to the memory budget, sorted and written out as runs. The runs are then
+ *    merged into the next level, dropping the boards of the level expanded and
+ *    of the one before it: a move reaches no other level. Only sequential reads
+ *    and writes are made, so spaces far beyond memory can be enumerated.
+ *
+ *    Tiles that are not kept are masked: they are all given one symbol and their
+ *    moves cost nothing, as in the abstract states of a pattern database. The
+ *    boards reached by free moves are added to a level until none is new, each
+ *    round expanding only the boards the last one added.
+**/
+typedef struct ExternalSearch {
+    ExternalOptions options;   //where and with how much memory the search runs
+    unsigned char isKept[MAX_BOARD_SIZE]; //set for the symbols whose moves cost 1; the blank is always kept
+    LevelVisitor visit;        //called on every board of every level; NULL for none
+    void *data;                //passed to `visit`
+    uint64_t levelSize[MAX_EXTERNAL_LEVELS]; //number of boards of each level
+    unsigned int levelCount;   //number of levels
+    uint64_t stateCount;       //number of boards enumerated
+    Board *buffer;             //the successors gathered before they are sorted
+    size_t bufferCapacity;     //number of boards `buffer` holds
+    size_t bufferCount;        //number of boards in `buffer`
+    unsigned int runCount;     //number of run files written since the runs were last merged
+    unsigned int maskSymbol;   //the symbol of the masked tiles; BOARD_SIZE if none is masked
+} ExternalSearch;
+
+/**
+ * DESCRIPTION: A file of boards read in order, one board ahead.
+**/
+typedef struct BoardReader {
+    FILE *file;                //the file read
+    Board board;               //the board read last
+    char hasBoard;             //set while `board` holds a board not consumed yet
+} BoardReader;
+
+/**
+ * DESCRIPTION:
+ *    This sets up `search` to enumerate every board, with no tile masked, in
+ *    `options->directory`.
+**/
+void initExternalSearch(ExternalSearch * const search, ExternalOptions const *options) {
+    memset(search, 0, sizeof(ExternalSearch));
+    search->options = *options;
+    memset(search->isKept, 1, sizeof(search->isKept));
+}
+
+/**
+ * DESCRIPTION: This writes the path of file `index` of kind `name` in the search's directory.
+**/
+static void externalPath(ExternalSearch const *search, char * const path, char const *name, unsigned int index) {
+    snprintf(path, FILENAME_MAX, "%s/%s-%u.bin", search->options.directory, name, index);
+}
+
+/**
+ * DESCRIPTION: This orders boards for `qsort()`.
+**/
+int compareBoards(void const *a, void const *b) {
+    Board first = *(Board const *)a, second = *(Board const *)b;
+    return first < second? -1 : first > second;
+}
+
+/**
+ * DESCRIPTION: This reads the next board of `reader`.
+**/
+void advanceBoardReader(BoardReader * const reader) {
+    reader->hasBoard = fread(&reader->board, sizeof(Board), 1, reader->file) == 1;
+}
+
+/**
+ * DESCRIPTION: This opens the file at `path` for reading and reads its first board.
+ * RETURN:
+ *    Returns 1 on success, 0 if the file cannot be opened.
+**/
+char openBoardReader(BoardReader * const reader, char const *path) {
+    reader->hasBoard = 0;
+    reader->file = fopen(path, "rb");
+    if(!reader->file)
+        return 0;
+
+    setvbuf(reader->file, NULL, _IOFBF, EXTERNAL_BUFFER_SIZE);
+    advanceBoardReader(reader);
+    return 1;
+}
+
+/**
+ * DESCRIPTION: This closes the file of `reader`, if it is open.
+ * RETURN:
+ *    Returns 1 if the file was read without error, 0 otherwise.
+**/
+char closeBoardReader(BoardReader * const reader) {
+    char success;
+
+    if(!reader->file)
+        return 1;
+
+    success = !ferror(reader->file);
+    fclose(reader->file);
+    reader->file = NULL;
+    reader->hasBoard = 0;
+    return success;
+}
+
+/**
+ * DESCRIPTION: This opens the file at `path` for writing.
+**/
+FILE* openBoardWriter(char const *path) {
+    FILE *file = fopen(path, "wb");
+
+    if(file)
+        setvbuf(file, NULL, _IOFBF, EXTERNAL_BUFFER_SIZE);
+    return file;
+}
+
+/**
+ * DESCRIPTION: This closes a file opened by `openBoardWriter()`.
+ * RETURN:
+ *    Returns 1 if every board was written, 0 otherwise.
+**/
+char closeBoardWriter(FILE *file) {
+    char success = !ferror(file);
+    return fclose(file) == 0 && success;
+}
+
+/**
+ * DESCRIPTION: This replaces the file at `target` with the one at `source`.
+**/
+char replaceFile(char const *source, char const *target) {
+    remove(target); //renaming onto an existing file fails on some systems
+    return rename(source, target) == 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This merges sorted files of boards into `output`, writing each board once
+ *    unless it is in one of the `excluded` files, which are sorted too.
+ * PARAMETERS:
+ *    inputs        - the files merged
+ *    inputCount    - number of `inputs`
+ *    excluded      - the files of the boards left out
+ *    excludedCount - number of `excluded`
+ *    output        - where the boards are written
+ *    count         - where the number of boards written is written to
+ * RETURN:
+ *    Returns 1 on success, 0 if a file cannot be read or written.
+**/
+char mergeBoards(BoardReader * const inputs, unsigned int inputCount, BoardReader * const excluded,
+        unsigned int excludedCount, FILE *output, uint64_t * const count) {
+    Board board, last = 0;
+    unsigned int i, best;
+    char hasLast = 0, isExcluded;
+
+    *count = 0;
+    for(;;) {
+        for(i = 0, best = inputCount; i < inputCount; ++i) {
+            if(inputs[i].hasBoard && (best == inputCount || inputs[i].board < inputs[best].board))
+                best = i;
+        }
+        if(best == inputCount)
+            break;
+
+        board = inputs[best].board;
+        advanceBoardReader(&inputs[best]);
+        if(hasLast && board == last)
+            continue;
+        last = board;
+        hasLast = 1;
+
+        //the excluded files are walked along with the inputs
+        for(i = 0, isExcluded = 0; i < excludedCount; ++i) {
+            while(excluded[i].hasBoard && excluded[i].board < board) {
+                advanceBoardReader(&excluded[i]);
+            }
+            isExcluded |= excluded[i].hasBoard && excluded[i].board == board;
+        }
+
+        if(!isExcluded) {
+            if(fwrite(&board, sizeof(Board), 1, output) != 1)
+                return 0;
+            ++*count;
+        }
+    }
+
+    for(i = 0; i < inputCount; ++i) {
+        if(ferror(inputs[i].file))
+            return 0;
+    }
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This sorts the successors gathered in memory and writes them, without
+ *    duplicates, as the next run file.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char flushSuccessors(ExternalSearch * const search) {
+    char path[FILENAME_MAX];
+    size_t i, count = 0;
+    FILE *file;
+
+    if(!search->bufferCount)
+        return 1;
+
+    qsort(search->buffer, search->bufferCount, sizeof(Board), compareBoards);
+    for(i = 0; i < search->bufferCount; ++i) {
+        if(!count || search->buffer[i] != search->buffer[count - 1])
+            search->buffer[count++] = search->buffer[i];
+    }
+
+    externalPath(search, path, "run", search->runCount);
+    if(!(file = openBoardWriter(path)))
+        return 0;
+    ++search->runCount;
+    search->bufferCount = 0;
+
+    if(fwrite(search->buffer, sizeof(Board), count, file) != count) {
+        fclose(file);
+        return 0;
+    }
+    return closeBoardWriter(file);
+}
+
+/**
+ * DESCRIPTION: This gathers a successor, writing the gathered ones out first if memory is full.
+**/
+static inline char addSuccessor(ExternalSearch * const search, Board board) {
+    if(search->bufferCount == search->bufferCapacity && !flushSuccessors(search))
+        return 0;
+
+    search->buffer[search->bufferCount++] = board;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This merges the run files `first` to `last` (excluded) into the file at
+ *    `path`, leaving out the boards of `excluded`, and deletes the runs.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char mergeRunFiles(ExternalSearch * const search, unsigned int first, unsigned int last, BoardReader * const excluded,
+        unsigned int excludedCount, char const *path, uint64_t * const count) {
+    BoardReader runs[EXTERNAL_MERGE_WAYS];
+    char runPath[FILENAME_MAX];
+    unsigned int i;
+    char success = 1;
+    FILE *output = openBoardWriter(path);
+
+    if(!output)
+        return 0;
+
+    for(i = first; i < last; ++i) {
+        externalPath(search, runPath, "run", i);
+        success &= openBoardReader(&runs[i - first], runPath);
+    }
+
+    success = success && mergeBoards(runs, last - first, excluded, excludedCount, output, count);
+    success &= closeBoardWriter(output);
+
+    for(i = first; i < last; ++i) {
+        success &= closeBoardReader(&runs[i - first]);
+        externalPath(search, runPath, "run", i);
+        remove(runPath);
+    }
+    return success;
+}
+
+/**
+ * DESCRIPTION:
+ *    This merges every run written since the last call into the file at `path`,
+ *    leaving out the boards of `excluded`. Runs beyond EXTERNAL_MERGE_WAYS are
+ *    first merged into larger runs, EXTERNAL_MERGE_WAYS at a time.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char collectRuns(ExternalSearch * const search, BoardReader * const excluded, unsigned int excludedCount,
+        char const *path, uint64_t * const count) {
+    char runPath[FILENAME_MAX];
+    unsigned int first = 0;
+    uint64_t merged;
+
+    if(!flushSuccessors(search))
+        return 0;
+
+    while(search->runCount - first > EXTERNAL_MERGE_WAYS) {
+        externalPath(search, runPath, "run", search->runCount);
+        if(!mergeRunFiles(search, first, first + EXTERNAL_MERGE_WAYS, NULL, 0, runPath, &merged))
+            return 0;
+        first += EXTERNAL_MERGE_WAYS;
+        ++search->runCount;
+    }
+
+    if(!mergeRunFiles(search, first, search->runCount, excluded, excludedCount, path, count))
+        return 0;
+    search->runCount = 0;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This gathers the successors of the boards of the file at `path`: those
+ *    reached by moving a kept tile if `isCostly` is set, those reached by moving
+ *    a masked tile otherwise.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char expandLevelFile(ExternalSearch * const search, char const *path, char isCostly) {
+    BoardReader reader;
+    State state, child;
+    Move move;
+    unsigned int cell;
+    char success = 1;
+
+    if(!openBoardReader(&reader, path))
+        return 0;
+
+    state.action = NOT_APPLICABLE;
+    for(; reader.hasBoard && success; advanceBoardReader(&reader)) {
+        state.board = reader.board;
+        for(cell = 0; getTile(state.board, cell) != BLANK_SYMBOL; ++cell);
+        state.blank = cell;
+
+        for(move = UP; move <= RIGHT && success; ++move) {
+            //the tile moved is the one in the blank's new cell
+            if(!createState(&state, move, &child)
+                    || (getTile(state.board, child.blank) != search->maskSymbol) != isCostly)
+                continue;
+
+            success = addSuccessor(search, child.board);
+        }
+    }
+
+    return closeBoardReader(&reader) && success;
+}
+
+/**
+ * DESCRIPTION: This calls the visitor of `search` on every board of level `level`, in the file at `path`.
+ * RETURN:
+ *    Returns 1 on success, 0 if the file cannot be read or the visitor aborts.
+**/
+char visitLevelFile(ExternalSearch * const search, char const *path, unsigned int level) {
+    BoardReader reader;
+    char success = 1;
+
+    if(!openBoardReader(&reader, path))
+        return 0;
+
+    for(; reader.hasBoard && success; advanceBoardReader(&reader)) {
+        success = search->visit(search->data, reader.board, level);
+    }
+    return closeBoardReader(&reader) && success;
+}
+
+/**
+ * DESCRIPTION: This merges the sorted files at `first` and `second` into the file at `path`.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char unionBoardFiles(char const *first, char const *second, char const *path, uint64_t * const count) {
+    BoardReader inputs[2];
+    FILE *output;
+    char success;
+
+    success = openBoardReader(&inputs[0], first);
+    success = openBoardReader(&inputs[1], second) && success;
+    if(success && (output = openBoardWriter(path))) {
+        success = mergeBoards(inputs, 2, NULL, 0, output, count);
+        success = closeBoardWriter(output) && success;
+    }
+    else {
+        success = 0;
+    }
+
+    success = closeBoardReader(&inputs[0]) && success;
+    success = closeBoardReader(&inputs[1]) && success;
+    return success;
+}
+
+/**
+ * DESCRIPTION:
+ *    This merges the runs gathered into the file at `path`, leaving out the
+ *    boards of the files at `excludedPaths`.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char collectRunsExcluding(ExternalSearch * const search, char const **excludedPaths, unsigned int excludedCount,
+        char const *path, uint64_t * const count) {
+    BoardReader excluded[2];
+    unsigned int i;
+    char success = 1;
+
+    for(i = 0; i < excludedCount; ++i) {
+        success = openBoardReader(&excluded[i], excludedPaths[i]) && success;
+    }
+
+    success = success && collectRuns(search, excluded, excludedCount, path, count);
+
+    for(i = 0; i < excludedCount; ++i) {
+        success = closeBoardReader(&excluded[i]) && success;
+    }
+    return success;
+}
+
+/**
+ * DESCRIPTION:
+ *    This enumerates the boards reachable from `goal` level by level, on disk,
+ *    counting the boards of each level and calling the visitor on each. The
+ *    files are deleted once the enumeration ends.
+ * RETURN:
+ *    Returns 1 on success; 0 if a file cannot be written or read, memory runs
+ *    out, the levels outnumber MAX_EXTERNAL_LEVELS or the visitor aborts.
+**/
+char enumerateLevels(ExternalSearch * const search, State const *goal) {
+    char previous[FILENAME_MAX], level[FILENAME_MAX], next[FILENAME_MAX]; //levels depth - 1, depth and depth + 1
+    char frontier[FILENAME_MAX], found[FILENAME_MAX], merged[FILENAME_MAX];
+    char const *excluded[2];
+    unsigned int cell, symbol, depth = 0;
+    uint64_t count;
+    Board root = 0;
+    char success = 0;
+
+    search->levelCount = 0;
+    search->stateCount = 0;
+    search->runCount = 0;
+    search->bufferCount = 0;
+    search->bufferCapacity = search->options.memoryBudget / sizeof(Board);
+    if(!search->bufferCapacity)
+        search->bufferCapacity = 1;
+    search->buffer = malloc(search->bufferCapacity * sizeof(Board));
+    if(!search->buffer)
+        return 0;
+
+    //the masked tiles all take the symbol of the first of them
+    for(search->maskSymbol = 1; search->maskSymbol < BOARD_SIZE && search->isKept[search->maskSymbol];
+        ++search->maskSymbol);
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        symbol = getTile(goal->board, cell);
+        if(symbol != BLANK_SYMBOL && !search->isKept[symbol])
+            symbol = search->maskSymbol;
+        root |= (Board)symbol << (TILE_BITS * cell);
+    }
+
+    previous[0] = '\0';
+    externalPath(search, level, "level", 0);
+    externalPath(search, next, "level", 1);
+    externalPath(search, frontier, "frontier", 0);
+    externalPath(search, found, "found", 0);
+    externalPath(search, merged, "merged", 0);
+    if(!addSuccessor(search, root) || !collectRuns(search, NULL, 0, level, &count))
+        goto cleanup;
+
+    for(;;) {
+        search->levelSize[depth] = count;
+
+        //boards reached by free moves join the level, until none is new
+        if(search->maskSymbol < BOARD_SIZE) {
+            if(!expandLevelFile(search, level, 0))
+                goto cleanup;
+
+            for(;;) {
+                excluded[0] = level;
+                if(!collectRunsExcluding(search, excluded, 1, found, &count))
+                    goto cleanup;
+                if(!count)
+                    break;
+
+                if(!unionBoardFiles(level, found, merged, &search->levelSize[depth]) || !replaceFile(merged, level)
+                        || !replaceFile(found, frontier) || !expandLevelFile(search, frontier, 0))
+                    goto cleanup;
+            }
+        }
+
+        search->stateCount += search->levelSize[depth];
+        search->levelCount = depth + 1;
+        if(search->visit && !visitLevelFile(search, level, depth))
+            goto cleanup;
+
+        //the next level is what moves of kept tiles reach, less this level and the one before
+        excluded[0] = level;
+        excluded[1] = previous;
+        if(!expandLevelFile(search, level, 1) || !collectRunsExcluding(search, excluded, depth? 2 : 1, next, &count))
+            goto cleanup;
+        if(depth && remove(previous))
+            goto cleanup;
+
+        strcpy(previous, level);
+        strcpy(level, next);
+        if(!count) {
+            success = 1;
+            break;
+        }
+        if(++depth == MAX_EXTERNAL_LEVELS)
+            goto cleanup;
+        externalPath(search, next, "level", depth + 1);
+    }
+
+cleanup:
+    for(cell = 0; cell < search->runCount; ++cell) {
+        externalPath(search, merged, "run", cell);
+        remove(merged);
+    }
+    externalPath(search, merged, "merged", 0);
+    remove(merged);
+    remove(frontier);
+    remove(found);
+    remove(level);
+    remove(next);
+    if(previous[0])
+        remove(previous);
+
+    free(search->buffer);
+    search->buffer = NULL;
+    return success;
+}
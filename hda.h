@@ -0,0 +1,398 @@
+#define HDA_MAX_THREADS 64     //most threads of a hash-distributed A*
+#define HDA_BATCH_SIZE 64      //nodes sent to another thread at once
+
+/**
+ * DESCRIPTION:
+ *    A batch of nodes sent from one thread of a hash-distributed A* to another.
+ *    Batches are linked into the inbox of the receiving thread.
+**/
+typedef struct NodeBatch {
+    struct NodeBatch *next;    //the batch sent before this one
+    unsigned int count;        //number of nodes in `nodes`
+    Node nodes[HDA_BATCH_SIZE]; //the nodes sent
+} NodeBatch;
+
+/**
+ * DESCRIPTION:
+ *    A thread of a hash-distributed A*. It owns every board that hashes to it:
+ *    only this thread records them in its closed set and expands them from its
+ *    open list. The children it generates are sent to their owners.
+**/
+typedef struct HashWorker {
+    struct HashSearch *search; //the search the worker belongs to
+    unsigned int id;           //the index of the worker in the search
+    pthread_t thread;          //the thread running `hashWorkerMain()`
+    SearchContext context;     //the statistics and closed set of the worker
+    NodeHeap open;             //the open list of the boards the worker owns
+    NodeBatch *inbox;          //the batches sent to the worker, most recent first;
+                               //pushed to by any thread, emptied by the worker
+    NodeBatch *outbox[HDA_MAX_THREADS]; //the batches being filled for each other worker
+    char isIdle;               //set while the worker has no node worth expanding
+} HashWorker;
+
+/**
+ * DESCRIPTION:
+ *    The state shared by the threads of a hash-distributed A*. The search ends
+ *    when `busy` drops to 0: it counts the workers that are not idle plus the
+ *    batches sent but not yet received. A worker only leaves idleness on
+ *    receiving a batch, which is itself counted, so once no worker is busy and
+ *    no batch is in flight, none can ever be again.
+**/
+typedef struct HashSearch {
+    State const *goal;         //the goal state
+    Heuristic const *heuristic; //the heuristic bound to `goal`
+    HashWorker *workers;       //the workers of the search
+    unsigned int workerCount;  //number of workers
+    unsigned int incumbent;    //the cost of the best solution found; UNVISITED_DEPTH if none
+    long busy;                 //busy workers plus batches in flight
+    char isAborted;            //set when memory runs out
+} HashSearch;
+
+/**
+ * DESCRIPTION: This finds the worker owning `board`.
+**/
+static inline unsigned int hashOwner(HashSearch const *search, Board board) {
+    return (unsigned int)((hashBoard(board) >> 32) % search->workerCount);
+}
+
+/**
+ * DESCRIPTION:
+ *    This takes `node` into the worker owning it: the node is dropped if it
+ *    cannot beat the best solution, or if its board was already reached at an
+ *    equal or lower cost, and is added to the open list otherwise.
+**/
+void receiveNode(HashWorker * const worker, Node const *node) {
+    HashSearch *search = worker->search;
+    State state;
+    int isNew;
+
+    if((unsigned int)totalCost(node) >= __atomic_load_n(&search->incumbent, __ATOMIC_RELAXED))
+        return;
+
+    nodeState(node, &state);
+    isNew = updateClosedSet(worker->context.closed, &state, node->depth);
+    if(isNew <= 0) {
+        if(isNew < 0)
+            __atomic_store_n(&search->isAborted, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if(!pushHeap(node, &worker->open))
+        __atomic_store_n(&search->isAborted, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * DESCRIPTION:
+ *    This pushes `batch` to the inbox of `target` with a compare-and-swap loop,
+ *    so any number of threads may send to it without a lock.
+**/
+void sendBatch(HashWorker * const target, NodeBatch * const batch) {
+    __atomic_add_fetch(&target->search->busy, 1, __ATOMIC_SEQ_CST);
+
+    batch->next = __atomic_load_n(&target->inbox, __ATOMIC_RELAXED);
+    while(!__atomic_compare_exchange_n(&target->inbox, &batch->next, batch, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/**
+ * DESCRIPTION:
+ *    This sends `node` to the worker owning it: straight into the open list if
+ *    it is `worker` itself, and otherwise into the batch being filled for the
+ *    owner, which is sent once full.
+**/
+void routeNode(HashWorker * const worker, Node const *node) {
+    HashSearch *search = worker->search;
+    unsigned int owner = hashOwner(search, node->board);
+    NodeBatch *batch;
+
+    if(owner == worker->id) {
+        receiveNode(worker, node);
+        return;
+    }
+
+    batch = worker->outbox[owner];
+    if(!batch) {
+        batch = malloc(sizeof(NodeBatch));
+        if(!batch) {
+            __atomic_store_n(&search->isAborted, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        batch->count = 0;
+        worker->outbox[owner] = batch;
+    }
+
+    batch->nodes[batch->count++] = *node;
+    if(batch->count == HDA_BATCH_SIZE) {
+        sendBatch(&search->workers[owner], batch);
+        worker->outbox[owner] = NULL;
+    }
+}
+
+/**
+ * DESCRIPTION: This sends every batch `worker` has started filling.
+**/
+void flushOutboxes(HashWorker * const worker) {
+    unsigned int i;
+
+    for(i = 0; i < worker->search->workerCount; ++i) {
+        if(worker->outbox[i]) {
+            sendBatch(&worker->search->workers[i], worker->outbox[i]);
+            worker->outbox[i] = NULL;
+        }
+    }
+}
+
+/**
+ * DESCRIPTION: This takes in every batch sent to `worker`.
+ * RETURN:
+ *    Returns 1 if a batch was received, 0 if the inbox was empty.
+**/
+char receiveBatches(HashWorker * const worker) {
+    HashSearch *search = worker->search;
+    NodeBatch *batch = __atomic_exchange_n(&worker->inbox, NULL, __ATOMIC_ACQUIRE);
+    NodeBatch *next;
+    unsigned int i;
+
+    if(!batch)
+        return 0;
+
+    //the batches held keep the search busy until the worker counts itself busy again
+    if(worker->isIdle) {
+        worker->isIdle = 0;
+        __atomic_add_fetch(&search->busy, 1, __ATOMIC_SEQ_CST);
+    }
+
+    for(; batch; batch = next) {
+        if(!__atomic_load_n(&search->isAborted, __ATOMIC_RELAXED)) {
+            for(i = 0; i < batch->count; ++i) {
+                receiveNode(worker, &batch->nodes[i]);
+            }
+        }
+
+        next = batch->next;
+        free(batch);
+        __atomic_sub_fetch(&search->busy, 1, __ATOMIC_SEQ_CST);
+    }
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This expands the best node of the open list of `worker`, or records it as
+ *    a solution if it is the goal. The children are generated with their
+ *    heuristic values, and left to their owners for duplicate detection.
+**/
+void expandOwnedNode(HashWorker * const worker) {
+    HashSearch *search = worker->search;
+    Node node, child;
+    State state, childState;
+    unsigned int known;
+    Move move;
+
+    if(!popHeap(&worker->open, &node))
+        return;
+
+    //skip nodes whose board was reached more cheaply since they were pushed
+    nodeState(&node, &state);
+    if(node.depth > readClosedDepth(worker->context.closed, &state))
+        return;
+
+    //a solution replaces the best one if it is shorter
+    if(node.board == search->goal->board) {
+        known = __atomic_load_n(&search->incumbent, __ATOMIC_RELAXED);
+        while(node.depth < known && !__atomic_compare_exchange_n(&search->incumbent, &known, node.depth, 1,
+            __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        return;
+    }
+
+    //no child of a node at the longest path cost can be recorded
+    if(node.depth >= MAX_PATH_COST)
+        worker->context.stats.isTooDeep = 1;
+
+    for(move = UP; move <= RIGHT && node.depth < MAX_PATH_COST; ++move) {
+        if(state.action == reverseMove[move] || !createState(&state, move, &childState))
+            continue;
+
+        createNode(&worker->context, node.depth + 1,
+            search->heuristic->update(search->heuristic->data, &state, &childState, node.hCost), &childState, &child);
+        routeNode(worker, &child);
+    }
+    ++worker->context.stats.nodesExpanded;
+}
+
+/**
+ * DESCRIPTION:
+ *    The loop of a worker. It takes in the batches sent to it and expands its
+ *    best node as long as that node may lead to a better solution, sending
+ *    what it has buffered every HDA_BATCH_SIZE expansions so that partly filled
+ *    batches do not hold back the other workers; then it sends the rest, counts
+ *    itself idle and waits for batches, until the whole search is idle.
+**/
+void* hashWorkerMain(void *data) {
+    HashWorker *worker = data;
+    HashSearch *search = worker->search;
+    unsigned int expansions = 0; //expansions since the outboxes were last sent
+
+    for(;;) {
+        receiveBatches(worker);
+
+        if(!__atomic_load_n(&search->isAborted, __ATOMIC_RELAXED) && worker->open.nodeCount > 0
+                && (unsigned int)totalCost(&worker->open.nodes[0]) < __atomic_load_n(&search->incumbent, __ATOMIC_RELAXED)) {
+            expandOwnedNode(worker);
+            if(++expansions == HDA_BATCH_SIZE) {
+                flushOutboxes(worker);
+                expansions = 0;
+            }
+            continue;
+        }
+
+        flushOutboxes(worker);
+        if(!worker->isIdle) {
+            worker->isIdle = 1;
+            __atomic_sub_fetch(&search->busy, 1, __ATOMIC_SEQ_CST);
+        }
+
+        if(__atomic_load_n(&search->busy, __ATOMIC_SEQ_CST) == 0)
+            break;
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+/**
+ * DESCRIPTION: The `DepthLookup` of a hash-distributed A*: the closed set of the board's owner.
+**/
+unsigned char readOwnedDepth(void const *data, State const *state) {
+    HashSearch const *search = data;
+
+    return readClosedDepth(search->workers[hashOwner(search, state->board)].context.closed, state);
+}
+
+/**
+ * DESCRIPTION:
+ *    Our hash-distributed A* (HDA*), for single instances too hard for one
+ *    thread. Every board is owned by the thread its hash points to, which alone
+ *    keeps it in its closed set and open list, so the threads share no table
+ *    and take no lock. The children a thread generates are sent in batches to
+ *    their owners through lock-free inboxes. A solution is only accepted once no
+ *    thread holds a node of lower total cost and no batch is in flight, so it is
+ *    as optimal as that of A*. The solution is traced back through the closed
+ *    sets of the owners.
+ * PARAMETERS:
+ *    context     - the search context to record statistics in
+ *    initial     - address to the initial state
+ *    goal        - address to the goal state
+ *    heuristic   - the heuristic bound to `goal`; NULL for the Manhattan distance
+ *    threadCount - number of threads; at most HDA_MAX_THREADS
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* HDAStar_search(SearchContext * const context, State *initial, State *goal, Heuristic const *heuristic,
+        unsigned int threadCount) {
+    HashSearch search = { goal, heuristic, NULL, threadCount, UNVISITED_DEPTH, 0, 0 };
+    SolutionPath *pathHead = NULL;
+    HashWorker *worker;
+    unsigned int started = 0, i;
+    Node root;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    //fall back to the Manhattan distance to the goal board
+    ManhattanTable distances;
+    Heuristic manhattan;
+    if(!heuristic) {
+        buildManhattanTable(goal, &distances);
+        useManhattan(&manhattan, &distances);
+        search.heuristic = &manhattan;
+    }
+
+    if(search.workerCount < 1)
+        search.workerCount = 1;
+    if(search.workerCount > HDA_MAX_THREADS)
+        search.workerCount = HDA_MAX_THREADS;
+
+    search.workers = calloc(search.workerCount, sizeof(HashWorker));
+    if(!search.workers) {
+        context->stats.isOutOfMemory = 1;
+        return NULL;
+    }
+
+    for(i = 0; i < search.workerCount; ++i) {
+        worker = &search.workers[i];
+        worker->search = &search;
+        worker->id = i;
+        worker->open.weight = 1;
+        initSearchContext(&worker->context);
+
+        //the workers share the memory budget of the search evenly
+        worker->context.memoryLeft = context->memoryLeft / search.workerCount;
+        worker->open.budget = &worker->context.memoryLeft;
+        if(!acquireClosedSet(&worker->context))
+            search.isAborted = 1;
+    }
+
+    //the root goes to its owner before any thread starts
+    if(!search.isAborted) {
+        worker = &search.workers[hashOwner(&search, initial->board)];
+        createNode(&worker->context, 0, search.heuristic->evaluate(search.heuristic->data, initial), initial, &root);
+        receiveNode(worker, &root);
+    }
+
+    //every worker starts busy, and counts itself idle once it runs out of nodes
+    search.busy = search.workerCount;
+    for(i = 0; i < search.workerCount && !search.isAborted; ++i, ++started) {
+        if(pthread_create(&search.workers[i].thread, NULL, hashWorkerMain, &search.workers[i]))
+            break;
+    }
+
+    //the workers that could not be started are stood in for, only to discard what they are sent
+    if(started < search.workerCount) {
+        __atomic_store_n(&search.isAborted, 1, __ATOMIC_RELAXED);
+        do {
+            for(i = started; i < search.workerCount; ++i) {
+                worker = &search.workers[i];
+                receiveBatches(worker);
+                if(!worker->isIdle) {
+                    worker->isIdle = 1;
+                    __atomic_sub_fetch(&search.busy, 1, __ATOMIC_SEQ_CST);
+                }
+            }
+            sched_yield();
+        } while(__atomic_load_n(&search.busy, __ATOMIC_SEQ_CST) != 0);
+    }
+    for(i = 0; i < started; ++i) {
+        pthread_join(search.workers[i].thread, NULL);
+    }
+
+    for(i = 0; i < search.workerCount; ++i) {
+        worker = &search.workers[i];
+        context->stats.nodesExpanded += worker->context.stats.nodesExpanded;
+        context->stats.nodesGenerated += worker->context.stats.nodesGenerated;
+        context->stats.isTooDeep |= worker->context.stats.isTooDeep;
+        context->stats.memoryUsed += worker->open.capacity * sizeof(Node);
+        if(worker->context.closed)
+            context->stats.memoryUsed += closedSetBytes(worker->context.closed);
+        destroyHeap(&worker->open);
+    }
+
+    //get solution path in order from the root, if it exists
+    if(!search.isAborted && search.incumbent != UNVISITED_DEPTH)
+        pathHead = traceDepthPath(context, readOwnedDepth, &search, goal);
+    context->stats.isOutOfMemory = search.isAborted;
+
+    for(i = 0; i < search.workerCount; ++i) {
+        destroySearchContext(&search.workers[i].context);
+    }
+    free(search.workers);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, "hdastar");
+
+    return pathHead;
+}
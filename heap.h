@@ -0,0 +1,146 @@
+#define INITIAL_HEAP_CAPACITY 256 //number of node slots allocated on first push
+
+/**
+ * DESCRIPTION:
+ *    An array-backed binary min-heap of nodes used as the open list of A*. The
+ *    node with the lowest priority g + w * h is kept at `nodes[0]`, where `w` is
+ *    the heap's `weight`: 1 orders nodes by total cost, as A* does, and larger
+ *    weights favor nodes closer to the goal, as weighted A* does. Ties are broken
+ *    in favor of the node with the lower heuristic value, i.e. the deeper node.
+ *    Nodes are stored by value, so the heap is the only memory they take.
+**/
+typedef struct NodeHeap {
+    unsigned int nodeCount;    //the number of nodes in the heap
+    unsigned int capacity;     //the number of slots allocated for `nodes`
+    Node *nodes;               //the heap-ordered array of nodes
+    double weight;             //the weight of the heuristic value in the priority
+    size_t *budget;            //the bytes the search may still allocate, charged as the
+                               //heap grows; NULL for no limit
+} NodeHeap;
+
+/**
+ * DESCRIPTION:
+ *    This determines whether `a` must be expanded before `b`.
+ * RETURN:
+ *    Returns 1 if `a` has higher priority than `b`, 0 otherwise.
+**/
+char heapBefore(NodeHeap const *heap, Node const *a, Node const *b) {
+    double costA = a->depth + heap->weight * a->hCost;
+    double costB = b->depth + heap->weight * b->hCost;
+
+    return costA < costB || (costA == costB && a->hCost < b->hCost);
+}
+
+/**
+ * DESCRIPTION:
+ *    This places `node` into slot `i` of the heap or below it, moving the
+ *    children of the slots it passes up. `node` may be a copy of a node past the
+ *    end of the heap, or the node of slot `i` itself.
+**/
+void siftDown(NodeHeap * const heap, unsigned int i, Node const *node) {
+    Node *nodes = heap->nodes;
+    Node moved = *node;
+    unsigned int count = heap->nodeCount;
+    unsigned int child;
+
+    while((child = 2 * i + 1) < count) {
+        if(child + 1 < count && heapBefore(heap, &nodes[child + 1], &nodes[child]))
+            ++child;
+        if(!heapBefore(heap, &nodes[child], &moved))
+            break;
+
+        nodes[i] = nodes[child];
+        i = child;
+    }
+    nodes[i] = moved;
+}
+
+/**
+ * DESCRIPTION:
+ *    This function pushes a node to the heap, growing its array as needed.
+ * PARAMETER:
+ *    node - the node to add to the heap; it is copied into the heap
+ *    heap - the heap to add the node into
+ * RETURN:
+ *    Returns 1 on success; 0 if the heap cannot grow within its budget or memory
+ *    runs out.
+**/
+char pushHeap(Node const *node, NodeHeap * const heap) {
+    PROFILE_BEGIN(PHASE_OPEN_PUSH);
+    if(heap->nodeCount == heap->capacity) {
+        unsigned int capacity = heap->capacity? heap->capacity * 2 : INITIAL_HEAP_CAPACITY;
+        Node *nodes = chargeMemory(heap->budget, (capacity - heap->capacity) * sizeof(Node))?
+            realloc(heap->nodes, capacity * sizeof(Node)) : NULL;
+        if(!nodes) {
+            PROFILE_END(PHASE_OPEN_PUSH);
+            return 0;
+        }
+
+        heap->nodes = nodes;
+        heap->capacity = capacity;
+    }
+
+    //sift the new node up from the bottom of the heap
+    Node *nodes = heap->nodes;
+    unsigned int i = heap->nodeCount++;
+
+    while(i > 0 && heapBefore(heap, node, &nodes[(i - 1) / 2])) {
+        nodes[i] = nodes[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    nodes[i] = *node;
+
+    PROFILE_END(PHASE_OPEN_PUSH);
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This detatchs the node with the highest priority from the heap.
+ * PARAMETER:
+ *    heap   - the heap to pop
+ *    popped - where the detatched node is written to
+ * RETURN:
+ *    Returns 1 if a node is popped; 0 if the heap is empty.
+**/
+char popHeap(NodeHeap * const heap, Node * const popped) {
+    if(heap->nodeCount == 0)
+        return 0;
+
+    PROFILE_BEGIN(PHASE_OPEN_POP);
+    *popped = heap->nodes[0];
+
+    //sift the last node down from the top of the heap
+    --heap->nodeCount;
+    siftDown(heap, 0, &heap->nodes[heap->nodeCount]);
+
+    PROFILE_END(PHASE_OPEN_POP);
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This changes the weight of the heap's priorities, and restores the heap
+ *    order under the new weight.
+**/
+void reweighHeap(NodeHeap * const heap, double weight) {
+    unsigned int i;
+
+    heap->weight = weight;
+    for(i = heap->nodeCount / 2; i > 0; --i) {
+        siftDown(heap, i - 1, &heap->nodes[i - 1]);
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This deallocates the array of the heap, along with the nodes left in it.
+**/
+void destroyHeap(NodeHeap * const heap) {
+    PROFILE_BEGIN(PHASE_TEARDOWN);
+    free(heap->nodes);
+    heap->nodes = NULL;
+    heap->nodeCount = 0;
+    heap->capacity = 0;
+    PROFILE_END(PHASE_TEARDOWN);
+}
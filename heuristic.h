@@ -0,0 +1,231 @@
+/**
+ * DESCRIPTION:
+ *    The interface through which the search engines evaluate heuristic values.
+ *    A heuristic is bound to one goal state when it is set up; `data` points to
+ *    the tables it has built for that goal.
+**/
+typedef struct Heuristic {
+    //heuristic value of `state`, computed from scratch
+    unsigned int (*evaluate)(void const *data, State const *state);
+
+    //heuristic value of `child`, one move away from `parent` whose value is `hCost`
+    unsigned int (*update)(void const *data, State const *parent, State const *child, unsigned int hCost);
+
+    void const *data; //tables of the heuristic
+} Heuristic;
+
+/**
+ * DESCRIPTION: The `evaluate` function of the Manhattan distance heuristic.
+**/
+unsigned int manhattanEvaluate(void const *data, State const *state) {
+    return manhattanDist(state, data);
+}
+
+/**
+ * DESCRIPTION: The `update` function of the Manhattan distance heuristic.
+**/
+unsigned int manhattanIncrement(void const *data, State const *parent, State const *child, unsigned int hCost) {
+    return manhattanUpdate(parent, child, hCost, data);
+}
+
+/**
+ * DESCRIPTION:
+ *    This sets up `heuristic` as the Manhattan distance to the goal `table` was
+ *    built for. The table must outlive the heuristic.
+**/
+void useManhattan(Heuristic * const heuristic, ManhattanTable const *table) {
+    heuristic->evaluate = manhattanEvaluate;
+    heuristic->update = manhattanIncrement;
+    heuristic->data = table;
+}
+
+#define CONFLICT_LINE_LIMIT 5     //rows and columns of at most this many cells get conflict tables
+#define CONFLICT_CODES 7776       //arrangements of a line of CONFLICT_LINE_LIMIT cells, 6^5
+
+/**
+ * DESCRIPTION:
+ *    The tables of the Manhattan distance plus linear conflicts. Two tiles are in
+ *    linear conflict when both are in their goal row (or column) but in reverse
+ *    order, so one of them must leave the line and come back, at 2 moves more
+ *    than their Manhattan distances. A line where `n` tiles are in their goal
+ *    line, of which at most `k` are already in order, costs 2 * (n - k) moves
+ *    more. The cost of every arrangement of a line is precomputed: each cell is
+ *    given a digit, the goal position in the line of its tile if the tile belongs
+ *    to the line and the line length otherwise, and the digits of a line form the
+ *    index of its cost. The digits are themselves looked up per cell and symbol,
+ *    already scaled to their place, so the index of a line is a plain sum of
+ *    table lookups, without any branch.
+**/
+typedef struct ConflictTable {
+    ManhattanTable manhattan;                   //the Manhattan distances to the goal
+    uint16_t rowDigit[BOARD_SIZE][BOARD_SIZE];  //rowDigit[cell][symbol], scaled to the cell's column
+    uint16_t colDigit[BOARD_SIZE][BOARD_SIZE];  //colDigit[cell][symbol], scaled to the cell's row
+    unsigned char rowCost[CONFLICT_CODES];      //extra moves of each arrangement of a row
+    unsigned char colCost[CONFLICT_CODES];      //extra moves of each arrangement of a column
+} ConflictTable;
+
+/**
+ * DESCRIPTION:
+ *    This fills `cost` with the extra moves of every arrangement of a line of
+ *    `length` cells, indexed by its digits in base `length + 1`, the first cell
+ *    being the least significant digit.
+**/
+void buildLineCosts(unsigned char * const cost, unsigned int length) {
+    unsigned int positions[CONFLICT_LINE_LIMIT]; //goal positions of the line's own tiles, in order
+    unsigned int longest[CONFLICT_LINE_LIMIT];   //longest increasing run ending at each of them
+    unsigned int codes = 1, index, code, count, best, i, j;
+
+    for(i = 0; i < length; ++i) {
+        codes *= length + 1;
+    }
+
+    for(index = 0; index < codes; ++index) {
+        count = 0;
+        for(code = index, i = 0; i < length; ++i, code /= length + 1) {
+            if(code % (length + 1) < length)
+                positions[count++] = code % (length + 1);
+        }
+
+        //the tiles that may stay are the longest increasing subsequence
+        best = 0;
+        for(i = 0; i < count; ++i) {
+            longest[i] = 1;
+            for(j = 0; j < i; ++j) {
+                if(positions[j] < positions[i] && longest[j] + 1 > longest[i])
+                    longest[i] = longest[j] + 1;
+            }
+            if(longest[i] > best)
+                best = longest[i];
+        }
+
+        cost[index] = 2 * (count - best);
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This fills `table` for `goal`.
+ * RETURN:
+ *    Returns 1 on success; 0 if a row or column is longer than CONFLICT_LINE_LIMIT.
+**/
+char buildConflictTable(State const *goal, ConflictTable * const table) {
+    unsigned int symbol, cell, goalCell, place;
+
+    if(BOARD_ROWS > CONFLICT_LINE_LIMIT || BOARD_COLS > CONFLICT_LINE_LIMIT)
+        return 0;
+
+    buildManhattanTable(goal, &table->manhattan);
+    buildLineCosts(table->rowCost, BOARD_COLS);
+    buildLineCosts(table->colCost, BOARD_ROWS);
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        table->rowDigit[cell][BLANK_SYMBOL] = BOARD_COLS;
+        table->colDigit[cell][BLANK_SYMBOL] = BOARD_ROWS;
+    }
+
+    for(goalCell = 0; goalCell < BOARD_SIZE; ++goalCell) {
+        symbol = getTile(goal->board, goalCell);
+        if(symbol == BLANK_SYMBOL)
+            continue;
+
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            table->rowDigit[cell][symbol] = cell / BOARD_COLS == goalCell / BOARD_COLS? goalCell % BOARD_COLS : BOARD_COLS;
+            table->colDigit[cell][symbol] = cell % BOARD_COLS == goalCell % BOARD_COLS? goalCell / BOARD_COLS : BOARD_ROWS;
+        }
+    }
+
+    //scale every digit to the place of its cell in its line
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        for(symbol = 0; symbol < BOARD_SIZE; ++symbol) {
+            for(place = 0; place < cell % BOARD_COLS; ++place) {
+                table->rowDigit[cell][symbol] *= BOARD_COLS + 1;
+            }
+            for(place = 0; place < cell / BOARD_COLS; ++place) {
+                table->colDigit[cell][symbol] *= BOARD_ROWS + 1;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * DESCRIPTION: This looks up the extra moves of row `row` of `board`.
+**/
+static inline unsigned int rowConflicts(ConflictTable const *table, Board board, unsigned int row) {
+    unsigned int index = 0, cell;
+
+    for(cell = row * BOARD_COLS; cell < (row + 1) * BOARD_COLS; ++cell) {
+        index += table->rowDigit[cell][getTile(board, cell)];
+    }
+    return table->rowCost[index];
+}
+
+/**
+ * DESCRIPTION: This looks up the extra moves of column `col` of `board`.
+**/
+static inline unsigned int colConflicts(ConflictTable const *table, Board board, unsigned int col) {
+    unsigned int index = 0, cell;
+
+    for(cell = col; cell < BOARD_SIZE; cell += BOARD_COLS) {
+        index += table->colDigit[cell][getTile(board, cell)];
+    }
+    return table->colCost[index];
+}
+
+/**
+ * DESCRIPTION: The `evaluate` function of the Manhattan distance plus linear conflicts.
+**/
+unsigned int conflictEvaluate(void const *data, State const *state) {
+    ConflictTable const *table = data;
+    unsigned int sum = manhattanDist(state, &table->manhattan), i;
+    PROFILE_BEGIN(PHASE_HEURISTIC);
+
+    for(i = 0; i < BOARD_ROWS; ++i) {
+        sum += rowConflicts(table, state->board, i);
+    }
+    for(i = 0; i < BOARD_COLS; ++i) {
+        sum += colConflicts(table, state->board, i);
+    }
+
+    PROFILE_END(PHASE_HEURISTIC);
+    return sum;
+}
+
+/**
+ * DESCRIPTION:
+ *    The `update` function of the Manhattan distance plus linear conflicts. The
+ *    moved tile only changes the order of the tiles of the two lines across its
+ *    move: the columns it leaves and enters on a horizontal move, and the rows
+ *    on a vertical one. Only those lines are looked up again.
+**/
+unsigned int conflictUpdate(void const *data, State const *parent, State const *child, unsigned int hCost) {
+    ConflictTable const *table = data;
+    unsigned int from = child->blank, to = parent->blank; //cells the tile moves between
+
+    hCost = manhattanUpdate(parent, child, hCost, &table->manhattan);
+    PROFILE_BEGIN(PHASE_HEURISTIC);
+
+    if(from / BOARD_COLS == to / BOARD_COLS) {
+        hCost += colConflicts(table, child->board, from % BOARD_COLS) + colConflicts(table, child->board, to % BOARD_COLS)
+            - colConflicts(table, parent->board, from % BOARD_COLS) - colConflicts(table, parent->board, to % BOARD_COLS);
+    }
+    else {
+        hCost += rowConflicts(table, child->board, from / BOARD_COLS) + rowConflicts(table, child->board, to / BOARD_COLS)
+            - rowConflicts(table, parent->board, from / BOARD_COLS) - rowConflicts(table, parent->board, to / BOARD_COLS);
+    }
+
+    PROFILE_END(PHASE_HEURISTIC);
+    return hCost;
+}
+
+/**
+ * DESCRIPTION:
+ *    This sets up `heuristic` as the Manhattan distance plus linear conflicts to
+ *    the goal `table` was built for. The table must outlive the heuristic.
+**/
+void useConflicts(Heuristic * const heuristic, ConflictTable const *table) {
+    heuristic->evaluate = conflictEvaluate;
+    heuristic->update = conflictUpdate;
+    heuristic->data = table;
+}
@@ -1,130 +1,236 @@
-//external variables declared from main.c
-extern unsigned int nodesExpanded; 
-extern unsigned int nodesGenerated;
-extern unsigned int solutionLength;
-extern double runtime;             
-
-/**
- * DESCRIPTION: This displays the '8-Puzzle Solver' ASCII art to the screen
-**/
-void welcomeUser(void) {
-    //style from: http://patorjk.com/software/taag/#p=display&f=Standard&t=8-Puzzle%20Solver
-    printf("\n\
-   ___        ____                _        ____        _\n\
-  ( _ )      |  _ \\ _   _ _______| | ___  / ___|  ___ | |_   _____ _ __\n\
-  / _ \\ _____| |_) | | | |_  /_  / |/ _ \\ \\___ \\ / _ \\| \\ \\ / / _ \\ '__|\n\
- | (_) |_____|  __/| |_| |/ / / /| |  __/  ___) | (_) | |\\ V /  __/ |\n\
-  \\___/      |_|    \\__,_/___/___|_|\\___| |____/ \\___/|_| \\_/ \\___|_|\n");
-}
-
-/**
- * DESCRIPTION: This displays the input instructions for the user to read
-**/
-void printInstructions(void) {
-    printf(
-        "------------------------------------------------------------------------\n"
-        "Instructions:\n"
-        "    Enter the initial and goal state of the 8-puzzle board. Input\n"
-        "    either integers 0-8, 0 representing the space character, to assign\n"
-        "    symbols toeach board[row][col].\n"
-        "------------------------------------------------------------------------\n"
-    );
-}
-
-/**
- * DESCRIPTION:
- *    This function fills `state` with non-repeating numbers from 0 to 9
-**/
-void inputState(State * const state) {
-    state->action = NOT_APPLICABLE;
-    char row, col;
-    int symbol;
-
-    // flags for input validation
-    char isNumUsed[9] = { 0 };
-
-    for(row = 0; row < 3; ++row) {
-        for(col = 0; col < 3; ++col) {
-            printf("    board[%i][%i]: ", row, col);
-
-            // to prevent scanning newline from the input stream
-            scanf("%i", &symbol);
-
-            // check if input is a blank character or is a number greater than 0 and less than 9
-            if(symbol >= 0 && symbol < 9) {
-                // check if input is repeated
-                if(!isNumUsed[symbol]) {
-                    state->board[row][col] = symbol + '0';
-                    isNumUsed[symbol] = 1;
-                }
-                else {
-                    printf("    ERROR: Number %c is already used. Try again with different input.\n", symbol);
-                    --col;
-                }
-            }
-            else {
-                printf("    ERROR: Invalid input. Enter a number from 0 to 8.\n");
-                --col;
-            }
-        }
-    }
-    printf("\n");
-}
-
-/**
- * DESCRIPTION: This displays contents of `board` to the standard output
-**/
-void printBoard(char const board[][3]) {
-    char row, col;
-
-    for(row = 0; row < 3; ++row) {
-        printf("+---+---+---+\n");
-        for(col = 0; col < 3; ++col) {
-            printf("| %c ", board[row][col]);
-        }
-        printf("|\n");
-    }
-    printf("+---+---+---+\n");
-}
-
-/**
- * DESCRIPTION:
- *    This function interprets numerical instructions of the move to make,
- *    to it's verbal counterpart to be displayed to the screen.
- * PARAMETER:
- *    solution - the solution path consisting a list of nodes from the root
- *               to the goal
-**/
-void printSolution(struct SolutionPath *path) {
-	//check if solution exists
-    if(!path) {
-        printf("No solution found.\n");
-        return;
-    }
-
-	//if the initial state is already the goal state
-	if(!path->next) {
-		printf("No moves needed. The initial state is already the goal state.\n");
-		return;
-	}
-
-    printf("SOLUTION: (Relative to the space character)\n");
-
-    //will use hash map to speed up the proccess a bit
-    char *move[4] = { "UP", "DOWN", "LEFT", "RIGHT" };
-    int counter = 1;
-
-    //will be skipping the first node since it represents the initial state with no action
-    for(path = path->next; path; path = path->next, ++counter) {
-        printf("%i. Move %s\n", counter, move[path->action]);
-    }
-
-    printf(
-        "DETAILS:\n"
-        " - Solution length : %i\n"
-        " - Nodes expanded  : %i\n"
-        " - Nodes generated : %i\n"
-        " - Runtime         : %g milliseconds\n"
-        " - Memory used     : %i bytes\n", //only counting allocated `Node`s
-        solutionLength, nodesExpanded, nodesGenerated, runtime, nodesGenerated * sizeof(Node));
-}
+/**
+ * DESCRIPTION: This displays the '8-Puzzle Solver' ASCII art to the screen
+**/
+void welcomeUser(void) {
+    //style from: http://patorjk.com/software/taag/#p=display&f=Standard&t=8-Puzzle%20Solver
+    printf("\n\
+   ___        ____                _        ____        _\n\
+  ( _ )      |  _ \\ _   _ _______| | ___  / ___|  ___ | |_   _____ _ __\n\
+  / _ \\ _____| |_) | | | |_  /_  / |/ _ \\ \\___ \\ / _ \\| \\ \\ / / _ \\ '__|\n\
+ | (_) |_____|  __/| |_| |/ / / /| |  __/  ___) | (_) | |\\ V /  __/ |\n\
+  \\___/      |_|    \\__,_/___/___|_|\\___| |____/ \\___/|_| \\_/ \\___|_|\n");
+}
+
+/**
+ * DESCRIPTION: This displays the input instructions for the user to read
+**/
+void printInstructions(void) {
+    printf(
+        "------------------------------------------------------------------------\n"
+        "Instructions:\n"
+        "    Enter the initial and goal state of the %i-puzzle board. Input\n"
+        "    either integers 0-%i, 0 representing the space character, to assign\n"
+        "    symbols toeach board[row][col].\n"
+        "------------------------------------------------------------------------\n",
+        BOARD_SIZE - 1, BOARD_SIZE - 1
+    );
+}
+
+/**
+ * DESCRIPTION:
+ *    This function fills `state` with non-repeating numbers from 0 to BOARD_SIZE - 1
+**/
+void inputState(State * const state) {
+    state->action = NOT_APPLICABLE;
+    unsigned char board[BOARD_ROWS][BOARD_COLS];
+    int row, col;
+    int symbol;
+
+    // flags for input validation
+    char isNumUsed[BOARD_SIZE] = { 0 };
+
+    for(row = 0; row < BOARD_ROWS; ++row) {
+        for(col = 0; col < BOARD_COLS; ++col) {
+            printf("    board[%i][%i]: ", row, col);
+
+            // to prevent scanning newline from the input stream
+            scanf("%i", &symbol);
+
+            // check if input is a blank character or is a number greater than 0 and less than BOARD_SIZE
+            if(symbol >= 0 && symbol < BOARD_SIZE) {
+                // check if input is repeated
+                if(!isNumUsed[symbol]) {
+                    board[row][col] = symbol;
+                    isNumUsed[symbol] = 1;
+                }
+                else {
+                    printf("    ERROR: Number %i is already used. Try again with different input.\n", symbol);
+                    --col;
+                }
+            }
+            else {
+                printf("    ERROR: Invalid input. Enter a number from 0 to %i.\n", BOARD_SIZE - 1);
+                --col;
+            }
+        }
+    }
+    packBoard(board, state);
+    printf("\n");
+}
+
+/**
+ * DESCRIPTION:
+ *    This reads a board written as one token of BOARD_SIZE symbols, row by row,
+ *    e.g. "281463750" for the 8-puzzle. Each symbol is one character: a digit, or
+ *    a letter from 'A' (10) onwards on boards of more than 10 cells.
+ * PARAMETERS:
+ *    text  - the text to read from; it is advanced past the token
+ *    state - where the board is written to
+ * RETURN:
+ *    Returns 1 if a valid board is read, 0 otherwise.
+**/
+char parseState(char const **text, State * const state) {
+    unsigned char board[BOARD_ROWS][BOARD_COLS];
+    char isNumUsed[BOARD_SIZE] = { 0 }; //flags for input validation
+    char const *c = *text;
+    int i, symbol;
+
+    while(*c == ' ' || *c == '\t')
+        ++c;
+
+    for(i = 0; i < BOARD_SIZE; ++i, ++c) {
+        if(*c >= '0' && *c <= '9')
+            symbol = *c - '0';
+        else if(*c >= 'A' && *c <= 'Z')
+            symbol = *c - 'A' + 10;
+        else if(*c >= 'a' && *c <= 'z')
+            symbol = *c - 'a' + 10;
+        else
+            return 0;
+
+        if(symbol >= BOARD_SIZE || isNumUsed[symbol])
+            return 0;
+
+        isNumUsed[symbol] = 1;
+        board[i / BOARD_COLS][i % BOARD_COLS] = symbol;
+    }
+
+    //the token must end right after the last symbol
+    if(*c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '\n')
+        return 0;
+
+    state->action = NOT_APPLICABLE;
+    packBoard(board, state);
+    *text = c;
+    return 1;
+}
+
+/**
+ * DESCRIPTION: This displays contents of `board` to the standard output
+**/
+void printBoard(unsigned char const board[][BOARD_COLS]) {
+    int width = BOARD_SIZE > 10? 2 : 1; //digits of the largest symbol
+    int row, col;
+
+    for(row = 0; row <= BOARD_ROWS; ++row) {
+        //print the horizontal border above the row
+        for(col = 0; col < BOARD_COLS; ++col) {
+            printf(width == 1? "+---" : "+----");
+        }
+        printf("+\n");
+
+        if(row == BOARD_ROWS)
+            break;
+
+        for(col = 0; col < BOARD_COLS; ++col) {
+            printf("| %*i ", width, board[row][col]);
+        }
+        printf("|\n");
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This function interprets numerical instructions of the move to make,
+ *    to it's verbal counterpart to be displayed to the screen.
+ * PARAMETER:
+ *    stats    - the statistics of the search that returned `path`
+ *    solution - the solution path consisting a list of nodes from the root
+ *               to the goal
+**/
+void printSolution(SearchStats const *stats, struct SolutionPath *path) {
+	//check if solution exists
+    if(!path) {
+        if(stats->isUnsolvable)
+            printf("No solution exists. The goal state is unreachable from the initial state (unsolvable).\n");
+        else if(stats->isOutOfMemory)
+            printf("No solution found. The search ran out of memory.\n");
+        else if(stats->isTooDeep)
+            printf("No solution found. Solutions longer than the search can record were cut.\n");
+        else
+            printf("No solution found.\n");
+        return;
+    }
+
+	//if the initial state is already the goal state
+	if(!path->next) {
+		printf("No moves needed. The initial state is already the goal state.\n");
+		return;
+	}
+
+    printf("SOLUTION: (Relative to the space character)\n");
+
+    //will use hash map to speed up the proccess a bit
+    char *move[4] = { "UP", "DOWN", "LEFT", "RIGHT" };
+    int counter = 1;
+
+    //will be skipping the first node since it represents the initial state with no action
+    for(path = path->next; path; path = path->next, ++counter) {
+        printf("%i. Move %s\n", counter, move[path->action]);
+    }
+
+    printf(
+        "DETAILS:\n"
+        " - Solution length : %i\n"
+        " - Nodes expanded  : %i\n"
+        " - Nodes generated : %i\n"
+        " - Runtime         : %g milliseconds\n"
+        " - Memory used     : %lu bytes\n", //peak bytes held by the search
+        stats->solutionLength, stats->nodesExpanded, stats->nodesGenerated, stats->runtime * 1000,
+        (unsigned long)stats->memoryUsed);
+
+    //the throughput of the level-synchronous BFS
+    if(stats->levelsExpanded && stats->runtime > 0) {
+        printf(
+            " - Levels/sec      : %.0f\n"
+            " - States/sec      : %.0f\n",
+            stats->levelsExpanded / stats->runtime, stats->nodesGenerated / stats->runtime);
+    }
+
+    //how far from the optimum the solution of the anytime A* may be
+    if(stats->bound > 0)
+        printf(" - Bound           : %.3f times the optimum\n", stats->bound);
+
+    //how often the solution cache has spared a search so far
+    if(stats->cacheHits || stats->cacheMisses)
+        printf(" - Cache           : %lu hits, %lu misses\n", stats->cacheHits, stats->cacheMisses);
+}
+
+/**
+ * DESCRIPTION:
+ *    This writes the result of a search as a single line for batch processing:
+ *        MOVES LENGTH EXPANDED GENERATED TIME
+ *    MOVES is the solution as letters U, D, L and R (relative to the blank), "-"
+ *    if no move is needed, "unsolvable" if the goal is unreachable, or "none" if
+ *    the search gave up. TIME is in milliseconds.
+ * PARAMETERS:
+ *    file  - the stream to write to
+ *    stats - the statistics of the search that returned `path`
+ *    path  - the solution path returned by the search; may be NULL
+**/
+void printResultLine(FILE *file, SearchStats const *stats, SolutionPath const *path) {
+    static const char letter[4] = { 'U', 'D', 'L', 'R' };
+
+    if(!path)
+        fputs(stats->isUnsolvable? "unsolvable" : "none", file);
+    else if(!path->next)
+        fputc('-', file);
+
+    //will be skipping the first node since it represents the initial state with no action
+    for(path = path? path->next : NULL; path; path = path->next) {
+        fputc(letter[path->action], file);
+    }
+
+    fprintf(file, " %u %u %u %.3f\n", stats->solutionLength, stats->nodesExpanded, stats->nodesGenerated,
+        stats->runtime * 1000);
+}
@@ -1,198 +1,330 @@
-/**
- * Authors:
- *  - Angelo Dina
- *  - Christian Collamar
-**/
-
-#include<stdio.h>
-#include<stdlib.h>
-#include<time.h>
-
-#include "state.h"
-#include "list.h"
-#include "node.h"
-#include "io.h"
-
-unsigned int nodesExpanded;  //number of expanded nodes
-unsigned int nodesGenerated; //number of generated nodes
-unsigned int solutionLength; //number of moves in solution
-double runtime;              //elapsed time (in milliseconds)
-
-SolutionPath* BFS_search(State *, State *);
-SolutionPath* AStar_search(State *, State *);
-
-int main(void) {
-    welcomeUser();           //display welcome message
-    printInstructions();     //display instructions
-
-    State initial;           //initial board state
-    State goalState;         //goal board configuration
-    
-    //solution path of each search method
-    SolutionPath *bfs;
-    SolutionPath *aStar;
-
-    //input initial board state
-    printf("INITIAL STATE:\n");
-    inputState(&initial);
-
-    //input the goal state
-    printf("\nGOAL STATE:\n");
-    inputState(&goalState);
-
-    printf("INITIAL BOARD STATE:\n");
-    printBoard(initial.board);
-
-    printf("GOAL BOARD STATE:\n");
-    printBoard(goalState.board);
-
-    //perform A* search
-    aStar = AStar_search(&initial, &goalState);
-    printf("\n-------------------------- USING A* ALGORITHM --------------------------\n");
-    printSolution(aStar);
-
-    //reset the counters
-    nodesExpanded = 0;
-    nodesGenerated = 0;
-    solutionLength = 0;
-    runtime = 0;
-
-    //perform breadth-first search
-    bfs = BFS_search(&initial, &goalState);
-    printf("\n------------------------- USING BFS ALGORITHM --------------------------\n");
-    printSolution(bfs);
-
-    //free resources
-    destroySolution(&bfs);
-    destroySolution(&aStar);
-
-    return 0;
-}
-
-/**
- * DESCRIPTION:
- *    Our breadth-first search implemetation.
- * PARAMETERS:
- *    initial - address to the initial state
- *    goal    - address to the goal state
- * RETURN:
- *    Returns the solution in a linked list; NULL if the solution is not found.
-**/
-SolutionPath* BFS_search(State *initial, State *goal) {
-    NodeList *queue = NULL;
-    NodeList *children = NULL;
-    Node *node = NULL;
-
-    //start timer
-    clock_t start = clock();
-
-    //initialize the queue with the root node of the search tree
-    pushNode(createNode(0, manhattanDist(initial, goal), initial, NULL), &queue);
-    Node *root = queue->head->currNode; //for deallocating the generated tree
-
-    //while there is a node in the queue to expand
-    while(queue->nodeCount > 0) {
-        //pop the last node (tail) of the queue
-        node = popNode(&queue);
-
-        //if the state of the node is the goal state
-        if(statesMatch(node->state, goal))
-            break;
-
-        //else, expand the node and update the expanded-nodes counter
-        children = getChildren(node, goal);
-        ++nodesExpanded;
-
-        //add the node's children to the queue
-        pushList(&children, queue);
-    }
-
-    //determine the time elapsed
-    runtime = (double)(clock() - start) / CLOCKS_PER_SEC;
-
-    //get solution path in order from the root, if it exists
-    SolutionPath *pathHead = NULL;
-    SolutionPath *newPathNode = NULL;
-
-    while(node) {
-        newPathNode = malloc(sizeof(SolutionPath));
-        newPathNode->action = node->state->action;
-        newPathNode->next = pathHead;
-        pathHead = newPathNode;
-
-        //update the solution length and move on the next node
-        ++solutionLength;
-        node = node->parent;
-    }
-
-    --solutionLength; //uncount the root node
-
-    //deallocate the generated tree
-    destroyTree(root);
-
-    return pathHead;
-}
-
-/**
- * DESCRIPTION:
- *    Our A* implemetation.
- * PARAMETERS:
- *    initial - address to the initial state
- *    goal    - address to the goal state
- * RETURN:
- *    Returns the solution in a linked list; NULL if the solution is not found.
-**/
-SolutionPath* AStar_search(State *initial, State *goal) {
-    NodeList *queue = NULL;
-    NodeList *children = NULL;
-    Node *node = NULL;
-
-    //start timer
-    clock_t start = clock();
-
-    //initialize the queue with the root node of the search tree
-    pushNode(createNode(0, manhattanDist(initial, goal), initial, NULL), &queue);
-    Node *root = queue->head->currNode; //for deallocating generated tree
-
-    //while there is a node in the queue to expand
-    while(queue->nodeCount > 0) {
-        //pop the last node (tail) of the queue
-        node = popNode(&queue);
-
-        //if the state of the node is the goal state
-        if(statesMatch(node->state, goal))
-            break;
-
-        //else, expand the node and update the expanded-nodes counter
-        children = getChildren(node, goal);
-        ++nodesExpanded;
-
-        //add the node's children to the queue
-        pushListInOrder(&children, queue);
-    }
-
-    //determine the time elapsed
-    runtime = (double)(clock() - start) / CLOCKS_PER_SEC;
-
-    //get solution path in order from the root, if it exists
-    SolutionPath *pathHead = NULL;
-    SolutionPath *newPathNode = NULL;
-
-    while(node) {
-        newPathNode = malloc(sizeof(SolutionPath));
-        newPathNode->action = node->state->action;
-        newPathNode->next = pathHead;
-        pathHead = newPathNode;
-
-        //update the solution length and move on the next node
-        ++solutionLength;
-        node = node->parent;
-    }
-
-    --solutionLength; //uncount the root node
-
-    //deallocate the generated tree
-    destroyTree(root);
-
-    return pathHead;
+/**
+ * Authors:
+ *  - Angelo Dina
+ *  - Christian Collamar
+**/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+#include<time.h>
+#include<limits.h>
+
+#include "profile.h"
+#include "state.h"
+#include "closed.h"
+#include "context.h"
+#include "heuristic.h"
+#include "node.h"
+#include "list.h"
+#include "heap.h"
+#include "io.h"
+#include "mapfile.h"
+#include "external.h"
+#include "pdb.h"
+#include "walking.h"
+#include "search.h"
+#include "table.h"
+#include "pool.h"
+#include "parallel.h"
+#include "hda.h"
+#include "sma.h"
+#include "cache.h"
+#include "batch.h"
+
+/**
+ * DESCRIPTION: The `report` callback of the anytime A*, printing each solution it finds.
+**/
+char printAnytimeProgress(void *data, AnytimeProgress const *progress) {
+    (void)data;
+    printf("Found %u moves with weight %.2f after %g milliseconds, within %.3f times the optimum.\n",
+        progress->incumbentLength, progress->weight, progress->elapsed * 1000, progress->bound);
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This enumerates, on disk, the boards reachable from the goal read from the
+ *    standard input, and writes the number of boards at each distance from it.
+ * RETURN:
+ *    Returns the exit status of the program.
+**/
+int enumerateGoal(ExternalOptions const *options) {
+    char line[BATCH_LINE_SIZE];
+    char const *text = line;
+    ExternalSearch search;
+    State goal;
+    unsigned int depth;
+    double start;
+
+    if(!fgets(line, sizeof(line), stdin) || !parseState(&text, &goal)) {
+        fprintf(stderr, "ERROR: Expected a goal board on the standard input.\n");
+        return 1;
+    }
+
+    initExternalSearch(&search, options);
+    start = readClock();
+    if(!enumerateLevels(&search, &goal)) {
+        fprintf(stderr, "ERROR: Could not enumerate the boards in %s.\n", options->directory);
+        return 1;
+    }
+
+    for(depth = 0; depth < search.levelCount; ++depth) {
+        printf("%u %llu\n", depth, (unsigned long long)search.levelSize[depth]);
+    }
+    fprintf(stderr, "Enumerated %llu boards in %u levels in %.3f seconds.\n", (unsigned long long)search.stateCount,
+        search.levelCount, readClock() - start);
+    return 0;
+}
+
+/**
+ * USAGE:
+ *    Solver [--heuristic NAME | --pdb FILE] [--table FILE] [--weight W] [--deadline MS]
+ *           [--batch [FILE] [--engine ENGINE] [--threads N] [--cache N]]
+ *           [--scratch DIR] [--memory MB] [--enumerate]
+ * OPTIONS:
+ *    --heuristic NAME - the heuristic of A* and IDA*: manhattan (default), conflict
+ *                      (Manhattan distance plus linear conflicts) or walking
+ *                      (walking distance, for boards of at most 4 rows and columns)
+ *    --pdb FILE      - use pattern databases instead of the Manhattan distance for
+ *                      A* and IDA*. They are mapped from FILE if it holds databases
+ *                      for the goal state, otherwise they are built and saved to FILE.
+ *    --table FILE    - look solutions up in the distance table of the goal state,
+ *                      which is mapped from FILE or built and saved to FILE. In
+ *                      batch mode, the table in FILE is used whatever its goal, and
+ *                      instances of other goals are solved with the engine.
+ *    --batch [FILE]  - solve the instances listed in FILE, or in the standard input
+ *                      if FILE is omitted or "-", without prompting; see `solveBatch()`
+ *    --weight W      - the weight of the heuristic value in weighted A*, and of the
+ *                      first solution of the anytime A*; 2 by default
+ *    --deadline MS   - the time after which the anytime A* returns the best solution
+ *                      it has found; none by default
+ *    --engine ENGINE - the engine of batch mode: astar (default), idastar, bfs, bibfs,
+ *                      wastar (weighted A*), arastar (anytime A*), hdastar (parallel
+ *                      A*, solving one instance at a time with every thread) or
+ *                      smastar (A* bounded by --memory)
+ *    --threads N     - the number of threads of batch mode, of the parallel BFS and
+ *                      of HDA*; all processors by default
+ *    --cache N       - remember up to N solutions in batch mode, and answer instances
+ *                      seen before, or equal to one up to the names of their tiles,
+ *                      from them; none by default
+ *    --scratch DIR   - build pattern databases on disk, in files under DIR, so
+ *                      that they need not fit in memory while they are built
+ *    --memory MB     - the megabytes of boards sorted in memory at once on disk, and
+ *                      that a search may hold; SMA* solves the instances other
+ *                      engines run out of memory on within them. 256 by default
+ *    --enumerate     - read a goal board from the standard input and write the
+ *                      number of boards at each distance from it, enumerated on
+ *                      disk under the scratch directory (the current one by default)
+**/
+int main(int argc, char **argv) {
+    char const *pdbPath = NULL;   //file of the pattern databases, if used
+    HeuristicKind heuristicKind = HEURISTIC_MANHATTAN; //heuristic of A* and IDA*
+    char const *tablePath = NULL; //file of the distance table, if used
+    char const *batchPath = NULL; //file of the instances of batch mode; "-" for stdin
+    Engine engine = ENGINE_ASTAR; //engine of batch mode
+    unsigned int threadCount = countProcessors(); //threads of batch mode
+    size_t cacheSize = 0;         //solutions cached in batch mode
+    AnytimeOptions anytime = { ANYTIME_WEIGHT, ANYTIME_WEIGHT_STEP, 0, NULL, NULL }; //options of weighted and anytime A*
+    ExternalOptions external = { NULL, DEFAULT_EXTERNAL_MEMORY }; //directory and memory of searches on disk
+    char isEnumerating = 0;       //set to enumerate the boards on disk
+    int i, status;
+
+    for(i = 1; i < argc; ++i) {
+        if(!strcmp(argv[i], "--pdb") && i + 1 < argc) {
+            pdbPath = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--heuristic") && i + 1 < argc && parseHeuristic(argv[i + 1], &heuristicKind)) {
+            ++i;
+        }
+        else if(!strcmp(argv[i], "--table") && i + 1 < argc) {
+            tablePath = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--batch")) {
+            batchPath = i + 1 < argc && strncmp(argv[i + 1], "--", 2)? argv[++i] : "-";
+        }
+        else if(!strcmp(argv[i], "--engine") && i + 1 < argc && parseEngine(argv[i + 1], &engine)) {
+            ++i;
+        }
+        else if(!strcmp(argv[i], "--threads") && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            threadCount = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--cache") && i + 1 < argc && atol(argv[i + 1]) > 0) {
+            cacheSize = atol(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--weight") && i + 1 < argc && atof(argv[i + 1]) >= 1) {
+            anytime.weight = atof(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--deadline") && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            anytime.timeLimit = atof(argv[++i]) / 1000;
+        }
+        else if(!strcmp(argv[i], "--scratch") && i + 1 < argc) {
+            external.directory = argv[++i];
+        }
+        else if(!strcmp(argv[i], "--memory") && i + 1 < argc && atof(argv[i + 1]) > 0) {
+            external.memoryBudget = (size_t)(atof(argv[++i]) * (1 << 20));
+        }
+        else if(!strcmp(argv[i], "--enumerate")) {
+            isEnumerating = 1;
+        }
+        else {
+            fprintf(stderr, "Usage: %s [--heuristic manhattan|conflict|walking | --pdb FILE] [--table FILE] [--weight W] [--deadline MS] "
+                "[--batch [FILE] [--engine astar|idastar|bfs|bibfs|wastar|arastar|hdastar|smastar] [--threads N] [--cache N]] "
+                "[--scratch DIR] [--memory MB] [--enumerate]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    //pattern databases take the place of any other heuristic
+    GoalHeuristic goalHeuristic; //tables of the heuristic
+    initGoalHeuristic(&goalHeuristic, pdbPath? HEURISTIC_PATTERN : heuristicKind, pdbPath);
+    if(external.directory)
+        goalHeuristic.external = &external;
+
+    if(isEnumerating) {
+        if(!external.directory)
+            external.directory = ".";
+        return enumerateGoal(&external);
+    }
+
+    if(batchPath) {
+        FILE *input = strcmp(batchPath, "-")? fopen(batchPath, "r") : stdin;
+        if(!input) {
+            fprintf(stderr, "ERROR: Could not open %s.\n", batchPath);
+            return 1;
+        }
+
+        status = solveBatch(input, engine, &goalHeuristic, tablePath, cacheSize, threadCount, &anytime,
+            external.memoryBudget);
+        if(input != stdin)
+            fclose(input);
+        return status;
+    }
+
+    welcomeUser();           //display welcome message
+    printInstructions();     //display instructions
+
+    State initial;           //initial board state
+    State goalState;         //goal board configuration
+    unsigned char board[BOARD_ROWS][BOARD_COLS]; //unpacked board for display
+
+    Heuristic const *heuristic;  //heuristic of A* and IDA*; NULL for the Manhattan distance
+    DistanceTable table;         //distances to the goal state
+    
+    SearchContext context;       //the allocations and statistics of each search
+    initSearchContext(&context);
+    context.memoryLimit = external.memoryBudget;
+
+    //solution path of each search method
+    SolutionPath *bfs;
+    SolutionPath *aStar;
+    SolutionPath *idaStar;
+    SolutionPath *weightedAStar;
+    SolutionPath *anytimeAStar;
+    SolutionPath *hdaStar;
+    SolutionPath *smaStar;
+    SolutionPath *biBfs;
+    SolutionPath *parallelBfs;
+    ThreadPool pool;             //the threads of the parallel BFS
+
+    //input initial board state
+    printf("INITIAL STATE:\n");
+    inputState(&initial);
+
+    //input the goal state
+    printf("\nGOAL STATE:\n");
+    inputState(&goalState);
+
+    printf("INITIAL BOARD STATE:\n");
+    unpackBoard(&initial, board);
+    printBoard(board);
+
+    printf("GOAL BOARD STATE:\n");
+    unpackBoard(&goalState, board);
+    printBoard(board);
+
+    //build the heuristic's tables; pattern databases are mapped if they are up to date
+    if(!prepareGoalHeuristic(&goalHeuristic, &goalState, &heuristic))
+        return 1;
+
+    //look the solution up in the distance table
+    if(tablePath) {
+        SolutionPath *lookup;
+
+        printf("\n----------------------- USING THE DISTANCE TABLE -----------------------\n");
+        if(prepareDistanceTable(&table, tablePath, &goalState)) {
+            lookup = Table_search(&context, &table, &initial, &goalState);
+            printSolution(&context.stats, lookup);
+            destroySolution(&lookup);
+            destroyDistanceTable(&table);
+        }
+        else {
+            printf("No distance table can be built for this board.\n");
+        }
+    }
+
+    //perform A* search
+    aStar = AStar_search(&context, &initial, &goalState, heuristic);
+    printf("\n-------------------------- USING A* ALGORITHM --------------------------\n");
+    printSolution(&context.stats, aStar);
+
+    //perform iterative-deepening A* search
+    idaStar = IDAStar_search(&context, &initial, &goalState, heuristic);
+    printf("\n------------------------- USING IDA* ALGORITHM -------------------------\n");
+    printSolution(&context.stats, idaStar);
+
+    //perform weighted A* search
+    weightedAStar = WeightedAStar_search(&context, &initial, &goalState, heuristic, anytime.weight);
+    printf("\n---------------------- USING WEIGHTED A* ALGORITHM ---------------------\n");
+    printSolution(&context.stats, weightedAStar);
+
+    //perform anytime A* search, reporting every solution it improves on
+    printf("\n---------------------- USING ANYTIME A* ALGORITHM ----------------------\n");
+    anytime.report = printAnytimeProgress;
+    anytimeAStar = AnytimeAStar_search(&context, &initial, &goalState, heuristic, &anytime);
+    printSolution(&context.stats, anytimeAStar);
+
+    //perform hash-distributed A* search with every thread
+    hdaStar = HDAStar_search(&context, &initial, &goalState, heuristic, threadCount);
+    printf("\n------------------------- USING HDA* ALGORITHM -------------------------\n");
+    printSolution(&context.stats, hdaStar);
+
+    //perform memory-bounded A* search
+    smaStar = SMAStar_search(&context, &initial, &goalState, heuristic, external.memoryBudget);
+    printf("\n------------------------- USING SMA* ALGORITHM -------------------------\n");
+    printSolution(&context.stats, smaStar);
+
+    //perform breadth-first search
+    bfs = BFS_search(&context, &initial, &goalState);
+    printf("\n------------------------- USING BFS ALGORITHM --------------------------\n");
+    printSolution(&context.stats, bfs);
+
+    //perform bidirectional breadth-first search
+    biBfs = BidirectionalBFS_search(&context, &initial, &goalState);
+    printf("\n-------------------- USING BIDIRECTIONAL BFS ALGORITHM -----------------\n");
+    printSolution(&context.stats, biBfs);
+
+    //perform parallel breadth-first search, if the board can be ranked into a bitmap
+    if(BOARD_SIZE <= LEVEL_BFS_LIMIT && createPool(&pool, threadCount)) {
+        parallelBfs = ParallelBFS_search(&context, &pool, &initial, &goalState);
+        printf("\n--------------------- USING PARALLEL BFS ALGORITHM ---------------------\n");
+        printSolution(&context.stats, parallelBfs);
+        destroySolution(&parallelBfs);
+        destroyPool(&pool);
+    }
+
+    //free resources
+    destroySolution(&bfs);
+    destroySolution(&aStar);
+    destroySolution(&idaStar);
+    destroySolution(&weightedAStar);
+    destroySolution(&anytimeAStar);
+    destroySolution(&hdaStar);
+    destroySolution(&smaStar);
+    destroySolution(&biBfs);
+    destroySearchContext(&context);
+    destroyGoalHeuristic(&goalHeuristic);
+
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifdef _WIN32
+#include<stdio.h>
+#else
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#endif
+
+/**
+ * DESCRIPTION:
+ *    This maps the whole file at `path` into memory for reading. Where memory
+ *    mapping is not available, the file is read into an allocated buffer instead.
+ * PARAMETERS:
+ *    path - the file to map
+ *    size - where the size of the file is written to
+ * RETURN:
+ *    Returns the address of the file's contents, or NULL on failure.
+**/
+void* mapFile(char const *path, size_t * const size) {
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    void *contents = NULL;
+
+    if(!file)
+        return NULL;
+
+    if(fseek(file, 0, SEEK_END) == 0 && (*size = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        contents = malloc(*size);
+        if(contents && fread(contents, 1, *size, file) != *size) {
+            free(contents);
+            contents = NULL;
+        }
+    }
+
+    fclose(file);
+    return contents;
+#else
+    struct stat info;
+    void *contents;
+    int file = open(path, O_RDONLY);
+
+    if(file < 0)
+        return NULL;
+
+    if(fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return NULL;
+    }
+
+    *size = info.st_size;
+    contents = mmap(NULL, *size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    return contents == MAP_FAILED? NULL : contents;
+#endif
+}
+
+/**
+ * DESCRIPTION: This releases the contents of a file mapped by `mapFile()`.
+**/
+void unmapFile(void *contents, size_t size) {
+    if(!contents)
+        return;
+
+#ifdef _WIN32
+    (void)size;
+    free(contents);
+#else
+    munmap(contents, size);
+#endif
+}
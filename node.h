@@ -1,124 +1,112 @@
-extern unsigned int nodesGenerated; //declared from main.c
-
-/**
- * DESCRIPTION: Defines the node structure used to create a search tree
-**/
-typedef struct Node Node;
-struct Node {
-    unsigned int depth; //depth of the node from the root. For A* search,
-                        //this will also represent the node's path cost
-    unsigned int hCost; //heuristic cost of the node
-    State *state;       //state designated to a node
-    Node *parent;       //parent node
-    NodeList *children; //list of child nodes
-};
-
-/**
- * DESCRIPTION:
- *    This function creates a node, initializes it with the
- *    following parameters, and sets its children to NULL.
- * PARAMETERS:
- *    d - depth of the node
- *    h - heuristic value of the node
- *    s - state assignated to the node
- *    p - parent node
- * RETURN:
- *    Returns a `Node` pointer to the dynamically allocated node,
- *    or NULL on failure.
-**/
-Node* createNode(unsigned int d, unsigned int h, State *s, Node *p) {
-    Node *newNode = malloc(sizeof(Node));
-    if(newNode) {
-        newNode->depth = d;
-        newNode->hCost = h;
-        newNode->state = s;
-        newNode->parent = p;
-        newNode->children = NULL;
-        ++nodesGenerated; //update counter
-    }
-    return newNode;
-}
-
-/**
- * DESCRIPTION:
- *    This function is used to deallocate all nodes in a tree, including
- *    the root node.
- * PARAMETER:
- *    node - the root node of the tree to deallocate
-**/
-void destroyTree(Node *node) {
-    if(node->children == NULL) {
-        free(node->state);
-        free(node);
-        return;
-    }
-
-    ListNode *listNode = node->children->head;
-    ListNode *nextNode;
-
-    while(listNode) {
-        nextNode = listNode->nextNode;
-        destroyTree(listNode->currNode);
-        listNode = nextNode;
-    }
-
-    //free(node->state);
-    free(node->children);
-    free(node);
-}
-
-/**
- * DESCRIPTION:
- *    This function 'expands' the node, links it to its children, and updates the
- *    expansion counter.
- * PARAMETER:
- *    parent    - the node to expand and search children for
- *    goalState - pointer to the goal state where heuristic values of each child will
- *                be based on
- * RETURN:
- *    Returns a pointer to `NodeList` on success, NULL on failure.
-**/
-NodeList* getChildren(Node *parent, State *goalState) {
-    NodeList *childrenPtr = NULL;
-    State *testState = NULL;
-    Node *child = NULL;
-
-    //attempt to create states for each moves, and add to the list of children if true
-    if(parent->state->action != DOWN && (testState = createState(parent->state, UP))) {
-        child = createNode(parent->depth + 1, manhattanDist(testState, goalState), testState, parent);
-        pushNode(child, &parent->children);
-        pushNode(child, &childrenPtr);
-    }
-    if(parent->state->action != UP && (testState = createState(parent->state, DOWN))) {
-        child = createNode(parent->depth + 1, manhattanDist(testState, goalState), testState, parent);
-        pushNode(child, &parent->children);
-        pushNode(child, &childrenPtr);
-    }
-    if(parent->state->action != RIGHT && (testState = createState(parent->state, LEFT))) {
-        child = createNode(parent->depth + 1, manhattanDist(testState, goalState), testState, parent);
-        pushNode(child, &parent->children);
-        pushNode(child, &childrenPtr);
-    }
-    if(parent->state->action != LEFT && (testState = createState(parent->state, RIGHT))) {
-        child = createNode(parent->depth + 1, manhattanDist(testState, goalState), testState, parent);
-        pushNode(child, &parent->children);
-        pushNode(child, &childrenPtr);
-    }
-
-    return childrenPtr;
-}
-
-/**
- * DESCRIPTION:
- *    This simply evaluates the node's total cost, i.e. path cost + heuristic value.
- *    Created to abstract the proccess and reduce code cluttering. Note that
- *    a node's path cost in a tree depends purely on the node's depth, so the node's
- *    depth will be representing the path cost (to save space).
- * PARAMETER:
-      node - the node to get its total cost
- * RETURN:
- *    Retuns the integer sum of the node's path cost and heuristic value
-**/
-int totalCost(Node * const node) {
-    return node->depth + node->hCost;
-}
+/**
+ * DESCRIPTION:
+ *    Defines the node structure the open lists are made of. A node holds nothing
+ *    but its packed board, its costs and the move that reached it: nodes are
+ *    stored by value in the open lists and have no link to their parent, since
+ *    the solution is traced back through the closed set instead.
+**/
+typedef struct Node {
+    Board board;               //packed board of the node's state
+    unsigned char depth;       //depth of the node from the root. For A* search,
+                               //this will also represent the node's path cost;
+                               //at most MAX_PATH_COST
+    unsigned char hCost;       //heuristic cost of the node
+    unsigned char blank : 6;   //index of the blank cell
+    unsigned char move : 2;    //move that resulted to the board; unused at the root
+} Node;
+
+/**
+ * DESCRIPTION:
+ *    This function initializes a node with the following parameters.
+ * PARAMETERS:
+ *    context - the search the node belongs to
+ *    d - depth of the node; below UNVISITED_DEPTH, like every path cost in the closed set
+ *    h - heuristic value of the node
+ *    s - state assignated to the node; it is packed into the node
+ *    node - the node to initialize
+**/
+void createNode(SearchContext * const context, unsigned int d, unsigned int h, State const *s, Node * const node) {
+    node->board = s->board;
+    node->depth = d;
+    node->hCost = h;
+    node->blank = s->blank;
+    node->move = s->action == NOT_APPLICABLE? 0 : s->action;
+    ++context->stats.nodesGenerated; //update counter
+}
+
+/**
+ * DESCRIPTION: This unpacks the state of `node` into `state`.
+**/
+void nodeState(Node const *node, State * const state) {
+    state->board = node->board;
+    state->blank = node->blank;
+    state->action = node->depth? (Move)node->move : NOT_APPLICABLE;
+}
+
+/**
+ * DESCRIPTION:
+ *    This function 'expands' the node into its children. Children whose board
+ *    has already been reached with an equal or lower path cost are not generated,
+ *    nor are those the closed set has no room for; the search is then marked
+ *    as out of memory in `context`. A node at MAX_PATH_COST has no children the
+ *    search can record, which is marked in `context` too.
+ * PARAMETER:
+ *    parent    - the node to expand and search children for
+ *    heuristic - the heuristic, bound to the goal state, that assigns the heuristic
+ *                values of each child
+ *    closed    - the closed set used for duplicate detection
+ *    context   - the search the children belong to
+ *    children  - where the children are written to; room for 4 nodes
+ * RETURN:
+ *    Returns the number of children written.
+**/
+unsigned int getChildren(Node const *parent, Heuristic const *heuristic, ClosedSet *closed, SearchContext * const context,
+        Node * const children) {
+    State parentState, testState;
+    unsigned int count = 0;
+    int isNew;
+    Move move;
+    PROFILE_BEGIN(PHASE_EXPANSION);
+
+    nodeState(parent, &parentState);
+
+    if(parent->depth >= MAX_PATH_COST) {
+        context->stats.isTooDeep = 1;
+        PROFILE_END(PHASE_EXPANSION);
+        return 0;
+    }
+
+    //attempt to create states for each moves, and add to the children if true
+    for(move = UP; move <= RIGHT; ++move) {
+        if(parentState.action == reverseMove[move] || !createState(&parentState, move, &testState))
+            continue;
+
+        //skip boards that are already reached through a path at least as short
+        isNew = updateClosedSet(closed, &testState, parent->depth + 1);
+        if(isNew < 0)
+            context->stats.isOutOfMemory = 1;
+        if(isNew <= 0)
+            continue;
+
+        createNode(context, parent->depth + 1,
+            heuristic->update(heuristic->data, &parentState, &testState, parent->hCost), &testState, &children[count++]);
+    }
+
+    PROFILE_END(PHASE_EXPANSION);
+    return count;
+}
+
+/**
+ * DESCRIPTION:
+ *    This simply evaluates the node's total cost, i.e. path cost + heuristic value.
+ *    Created to abstract the proccess and reduce code cluttering. Note that
+ *    a node's path cost in a tree depends purely on the node's depth, so the node's
+ *    depth will be representing the path cost (to save space).
+ * PARAMETER:
+      node - the node to get its total cost
+ * RETURN:
+ *    Retuns the integer sum of the node's path cost and heuristic value
+**/
+int totalCost(Node const * const node) {
+    return node->depth + node->hCost;
+}
@@ -0,0 +1,190 @@
+#define LEVEL_BFS_LIMIT 12     //boards with at most this many cells fit a visited bitmap
+#define LEVEL_CHUNK_SIZE 1024  //boards of a level expanded by a single pool task
+
+/**
+ * DESCRIPTION:
+ *    The state shared by the threads of a level-synchronous breadth-first search.
+ *    Boards are marked in `visited` by their rank from `rankState()`; the thread
+ *    that sets a board's bit is the only one to queue it and to record, in
+ *    `moves`, the move that reached it.
+**/
+typedef struct LevelSearch {
+    State const *goal;         //the goal state
+    uint64_t *visited;         //one bit per board rank, set once the board is reached
+    uint64_t *moves;           //two bits per board rank: the move that reached the board
+    State const *level;        //the boards of the level being expanded
+    size_t levelCount;         //number of boards in `level`
+    State *next;               //the boards of the level being generated
+    size_t nextCount;          //number of boards in `next`, updated atomically
+    unsigned int expanded;     //number of boards expanded, updated atomically
+    unsigned int generated;    //number of boards generated, updated atomically
+    char isGoalFound;          //set once the goal is generated
+} LevelSearch;
+
+/**
+ * DESCRIPTION:
+ *    The pool task expanding chunk `index` of the current level. Children are
+ *    gathered locally and then appended to the next level with a single atomic
+ *    reservation, so threads only contend once per chunk.
+**/
+void expandLevelChunk(void *data, unsigned int index, SearchContext *context) {
+    LevelSearch *search = data;
+    State children[4 * LEVEL_CHUNK_SIZE];
+    State const *state;
+    size_t first = (size_t)index * LEVEL_CHUNK_SIZE;
+    size_t last = first + LEVEL_CHUNK_SIZE < search->levelCount? first + LEVEL_CHUNK_SIZE : search->levelCount;
+    size_t count = 0, base;
+    uint64_t rank, bit;
+    char isGoalFound = 0;
+    Move move;
+
+    (void)context;
+
+    for(state = &search->level[first]; state < &search->level[last]; ++state) {
+        for(move = UP; move <= RIGHT; ++move) {
+            if(state->action == reverseMove[move] || !createState(state, move, &children[count]))
+                continue;
+
+            //only the thread that sets the bit keeps the board
+            rank = rankState(&children[count]);
+            bit = 1ull << (rank & 63);
+            if(__atomic_fetch_or(&search->visited[rank >> 6], bit, __ATOMIC_RELAXED) & bit)
+                continue;
+
+            __atomic_fetch_or(&search->moves[rank >> 5], (uint64_t)move << (2 * (rank & 31)), __ATOMIC_RELAXED);
+            isGoalFound |= statesMatch(&children[count], search->goal);
+            ++count;
+        }
+    }
+
+    base = __atomic_fetch_add(&search->nextCount, count, __ATOMIC_RELAXED);
+    memcpy(&search->next[base], children, count * sizeof(State));
+
+    __atomic_fetch_add(&search->expanded, (unsigned int)(last - first), __ATOMIC_RELAXED);
+    __atomic_fetch_add(&search->generated, (unsigned int)count, __ATOMIC_RELAXED);
+    if(isGoalFound)
+        __atomic_store_n(&search->isGoalFound, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * DESCRIPTION:
+ *    Our parallel breadth-first search. It is level-synchronous: every level is
+ *    a contiguous array of packed boards, split into chunks that the threads of
+ *    `pool` expand into the next level, and the search stops after the level in
+ *    which the goal is generated. Duplicates are dropped through an atomic
+ *    bitmap indexed by board rank, so it only runs on boards of at most
+ *    LEVEL_BFS_LIMIT cells. The solution is traced back from the goal through
+ *    the move recorded for each board, without any tree nodes.
+ * PARAMETERS:
+ *    context - the search context to record statistics in
+ *    pool    - the threads to expand the levels with
+ *    initial - address to the initial state
+ *    goal    - address to the goal state
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* ParallelBFS_search(SearchContext * const context, ThreadPool * const pool, State *initial, State *goal) {
+    LevelSearch search;
+    State *level = NULL;       //the array of the level being expanded
+    size_t levelCapacity = 0, nextCapacity = 0;
+    uint64_t boards = 1, rank;
+    Move path[MAX_SOLUTION_LENGTH];
+    State state;
+    SolutionPath *pathHead = NULL;
+    unsigned int i, depth = 0;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(BOARD_SIZE > LEVEL_BFS_LIMIT || !checkSolvable(context, initial, goal))
+        return NULL;
+
+    for(i = 2; i <= BOARD_SIZE; ++i) {
+        boards *= i;
+    }
+
+    search.goal = goal;
+    search.visited = calloc(boards / 64 + 1, sizeof(uint64_t));
+    search.moves = calloc(boards / 32 + 1, sizeof(uint64_t));
+    search.next = NULL;
+    search.expanded = 0;
+    search.generated = 1;
+    search.isGoalFound = statesMatch(initial, goal);
+
+    //the first level holds the initial state alone
+    level = malloc(sizeof(State));
+    if(!search.visited || !search.moves || !level) {
+        context->stats.isOutOfMemory = 1;
+        goto cleanup;
+    }
+
+    levelCapacity = 1;
+    level[0] = *initial;
+    level[0].action = NOT_APPLICABLE;
+    search.level = level;
+    search.levelCount = 1;
+
+    rank = rankState(initial);
+    search.visited[rank >> 6] |= 1ull << (rank & 63);
+
+    while(!search.isGoalFound && search.levelCount > 0 && depth < MAX_SOLUTION_LENGTH) {
+        //every board has at most four children, and three past the root
+        if(nextCapacity < 4 * search.levelCount) {
+            nextCapacity = 4 * search.levelCount;
+            free(search.next);
+            search.next = malloc(nextCapacity * sizeof(State));
+            if(!search.next) {
+                context->stats.isOutOfMemory = 1;
+                goto cleanup;
+            }
+        }
+
+        search.nextCount = 0;
+        runPool(pool, (search.levelCount + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE, expandLevelChunk, &search);
+        ++depth;
+
+        if(context->stats.memoryUsed < (levelCapacity + nextCapacity) * sizeof(State))
+            context->stats.memoryUsed = (levelCapacity + nextCapacity) * sizeof(State);
+
+        //the generated level is expanded next
+        State *expanded = level;
+        level = search.next;
+        search.next = expanded;
+        search.level = level;
+        search.levelCount = search.nextCount;
+
+        size_t capacity = levelCapacity;
+        levelCapacity = nextCapacity;
+        nextCapacity = capacity;
+    }
+
+    if(search.isGoalFound) {
+        //follow the recorded moves back from the goal
+        state = *goal;
+        for(i = depth; i > 0; --i) {
+            rank = rankState(&state);
+            path[i - 1] = (Move)((search.moves[rank >> 5] >> (2 * (rank & 31))) & 3);
+            createState(&state, reverseMove[path[i - 1]], &state);
+        }
+
+        context->stats.solutionLength = depth;
+        pathHead = createSolution(path, depth);
+    }
+
+cleanup:
+    context->stats.nodesExpanded = search.expanded;
+    context->stats.nodesGenerated = search.generated;
+    context->stats.levelsExpanded = depth;
+    context->stats.memoryUsed += (boards / 64 + 1 + boards / 32 + 1) * sizeof(uint64_t);
+
+    free(search.visited);
+    free(search.moves);
+    free(search.next);
+    free(level);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+
+    return pathHead;
+}
@@ -0,0 +1,726 @@
+//number of tiles per group of the default partition; the largest groups whose
+//databases can still be built in a few seconds
+#ifndef PATTERN_GROUP_SIZE
+#define PATTERN_GROUP_SIZE (BOARD_SIZE <= 9? 4 : BOARD_SIZE <= 16? 5 : 4)
+#endif
+
+#define MAX_PATTERN_GROUPS MAX_BOARD_SIZE //at most one group per tile
+#define UNREACHED_COST 0xFF               //cost of abstract states not reached yet
+#define PATTERN_FILE_MAGIC "PUZPDB02"     //first bytes of a pattern database file
+
+/**
+ * DESCRIPTION:
+ *    A pattern database for one group of tiles. It abstracts a board to the cells
+ *    of the group's tiles only, and records the fewest moves of those tiles needed
+ *    to bring them to their goal cells. Placements of the tiles are indexed by
+ *    their rank as a partial permutation of the cells.
+ *
+ *    A group that a symmetry of the goal carries another group onto needs no
+ *    database of its own: its tiles are looked up in the other group's, each
+ *    as the tile it is the image of, in the cell its cell is the image of.
+**/
+typedef struct PatternDatabase {
+    unsigned int partition;              //groups of the same partition are added together
+    unsigned int tileCount;              //number of tiles in the group
+    unsigned char tiles[MAX_BOARD_SIZE]; //the tiles of the group
+    unsigned int source;                 //the group whose database is used; this one's own index
+                                         //unless it is the image of an earlier group
+    unsigned char cellMap[MAX_BOARD_SIZE]; //the cell each cell is looked up as in `source`
+    uint64_t size;                       //number of entries of `distance`
+    unsigned char *distance;             //moves of the group's tiles needed, by placement rank;
+                                         //the database of `source`
+} PatternDatabase;
+
+/**
+ * DESCRIPTION:
+ *    A set of pattern databases bound to one goal state. Each partition is a set
+ *    of disjoint groups whose values are added together, which stays admissible
+ *    since only moves of a group's own tiles are counted. The heuristic value is
+ *    the maximum of the sums over all partitions.
+**/
+typedef struct PatternHeuristic {
+    State goal;                                 //the goal state the databases are built for
+    unsigned int groupCount;                    //number of groups
+    unsigned int partitionCount;                //number of partitions
+    PatternDatabase groups[MAX_PATTERN_GROUPS]; //the databases
+    void *mapping;                              //contents of the file the databases are
+    size_t mappingSize;                         //mapped from, if any, and its size
+} PatternHeuristic;
+
+/**
+ * DESCRIPTION: The header of a pattern database file.
+**/
+typedef struct PatternFileHeader {
+    char magic[8];                       //PATTERN_FILE_MAGIC
+    uint32_t rows, cols;                 //the board dimensions
+    uint32_t groupCount, partitionCount; //as in `PatternHeuristic`
+    unsigned char goal[MAX_BOARD_SIZE];  //the goal board, cell by cell
+} PatternFileHeader;
+
+/**
+ * DESCRIPTION:
+ *    The description of a group in a pattern database file. The headers of all
+ *    groups follow the file header, and the distances of the groups that have
+ *    their own follow them.
+**/
+typedef struct PatternFileGroup {
+    uint32_t partition, tileCount;       //as in `PatternDatabase`
+    unsigned char tiles[MAX_BOARD_SIZE]; //as in `PatternDatabase`
+    uint32_t source;                     //as in `PatternDatabase`; only groups that are their
+                                         //own source have their distances in the file
+    unsigned char cellMap[MAX_BOARD_SIZE]; //as in `PatternDatabase`
+    uint64_t size;                       //as in `PatternDatabase`
+} PatternFileGroup;
+
+/**
+ * DESCRIPTION:
+ *    This computes the number of ways `tileCount` tiles can be placed on the
+ *    board, i.e. BOARD_SIZE! / (BOARD_SIZE - tileCount)!.
+**/
+uint64_t countPlacements(unsigned int tileCount) {
+    uint64_t count = 1;
+    unsigned int i;
+
+    for(i = 0; i < tileCount; ++i) {
+        count *= BOARD_SIZE - i;
+    }
+    return count;
+}
+
+/**
+ * DESCRIPTION:
+ *    This ranks the cells of a group's tiles as a partial permutation, the same
+ *    way `rankState()` ranks a whole board.
+ * PARAMETERS:
+ *    cells     - the cell of each tile of the group, in the group's order
+ *    tileCount - number of tiles in the group
+ * RETURN:
+ *    Returns an integer in [0, countPlacements(tileCount)).
+**/
+uint64_t rankPlacement(unsigned char const *cells, unsigned int tileCount) {
+    uint64_t rank = 0;
+    unsigned int used = 0; //bit `n` is set once cell `n` has been ranked
+    unsigned int i;
+
+    for(i = 0; i < tileCount; ++i) {
+        rank = rank * (BOARD_SIZE - i) + cells[i] - __builtin_popcount(used & ((1u << cells[i]) - 1));
+        used |= 1u << cells[i];
+    }
+    return rank;
+}
+
+/**
+ * DESCRIPTION: This is the inverse of `rankPlacement()`.
+**/
+void unrankPlacement(uint64_t rank, unsigned int tileCount, unsigned char * const cells) {
+    unsigned int digits[MAX_BOARD_SIZE];
+    unsigned int used = 0;
+    unsigned int i, cell, skip;
+
+    //peel off the digits of the mixed-radix rank, last digit first
+    for(i = tileCount; i-- > 1; ) {
+        digits[i] = rank % (BOARD_SIZE - i);
+        rank /= BOARD_SIZE - i;
+    }
+    digits[0] = rank;
+
+    //each digit is the number of unused cells preceding the tile's cell
+    for(i = 0; i < tileCount; ++i) {
+        for(cell = 0, skip = digits[i]; ; ++cell) {
+            if(!(used & (1u << cell)) && skip-- == 0)
+                break;
+        }
+        cells[i] = cell;
+        used |= 1u << cell;
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This appends an abstract state to a growable queue.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char pushAbstractState(uint32_t **queue, size_t *count, size_t *capacity, uint32_t index) {
+    if(*count == *capacity) {
+        size_t newCapacity = *capacity? 2 * *capacity : 4096;
+        uint32_t *newQueue = realloc(*queue, newCapacity * sizeof(uint32_t));
+        if(!newQueue)
+            return 0;
+
+        *queue = newQueue;
+        *capacity = newCapacity;
+    }
+
+    (*queue)[(*count)++] = index;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds the distances of a group by a breadth-first search backward from
+ *    the goal over abstract states, i.e. the cells of the group's tiles together
+ *    with the cell of the blank. Moving the blank into a cell of no tile of the
+ *    group costs nothing, so the search keeps two queues: one for the current
+ *    cost, which such moves are appended to, and one for the next cost.
+ * PARAMETERS:
+ *    database - the group to build; its tiles must be set
+ *    goal     - the goal state
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char buildPatternDatabase(PatternDatabase * const database, State const *goal) {
+    unsigned int tileCount = database->tileCount;
+    uint64_t placements = countPlacements(tileCount);
+    uint64_t states = placements * BOARD_SIZE;   //abstract states, by placement and blank cell
+    unsigned char *cost;                          //cost of each abstract state
+    uint32_t *queue[2] = { NULL, NULL };          //abstract states to expand
+    size_t count[2] = { 0, 0 }, capacity[2] = { 0, 0 };
+    unsigned char cells[MAX_BOARD_SIZE];          //cell of each tile of the group
+    unsigned char occupant[MAX_BOARD_SIZE] = { 0 }; //1 + index of the group's tile in a cell, or 0
+    unsigned int i, cell, blank, current = 0, level = 0;
+    uint64_t rank, next;
+    size_t head;
+    int target;
+    Move move;
+    char success = 0;
+
+    if(states > UINT32_MAX)
+        return 0;
+
+    cost = malloc(states);
+    database->size = placements;
+    database->distance = malloc(placements);
+    if(!cost || !database->distance)
+        goto cleanup;
+
+    memset(cost, UNREACHED_COST, states);
+
+    //the search starts from the goal placement
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        for(i = 0; i < tileCount; ++i) {
+            if(getTile(goal->board, cell) == database->tiles[i])
+                cells[i] = cell;
+        }
+    }
+
+    next = rankPlacement(cells, tileCount) * BOARD_SIZE + goal->blank;
+    cost[next] = 0;
+    if(!pushAbstractState(&queue[current], &count[current], &capacity[current], next))
+        goto cleanup;
+
+    while(count[current] > 0) {
+        for(head = 0; head < count[current]; ++head) {
+            //skip states reached at a lower cost after they were queued
+            if(cost[queue[current][head]] != level)
+                continue;
+
+            rank = queue[current][head] / BOARD_SIZE;
+            blank = queue[current][head] % BOARD_SIZE;
+            unrankPlacement(rank, tileCount, cells);
+            for(i = 0; i < tileCount; ++i) {
+                occupant[cells[i]] = i + 1;
+            }
+
+            for(move = UP; move <= RIGHT; ++move) {
+                if((target = moveTable[blank][move]) < 0)
+                    continue;
+
+                if(occupant[target]) {
+                    //a tile of the group slides into the blank's cell
+                    i = occupant[target] - 1;
+                    cells[i] = blank;
+                    next = rankPlacement(cells, tileCount) * BOARD_SIZE + target;
+                    cells[i] = target;
+
+                    if(cost[next] > level + 1) {
+                        cost[next] = level + 1;
+                        if(!pushAbstractState(&queue[!current], &count[!current], &capacity[!current], next))
+                            goto cleanup;
+                    }
+                }
+                else {
+                    //any other tile slides for free
+                    next = rank * BOARD_SIZE + target;
+
+                    if(cost[next] > level) {
+                        cost[next] = level;
+                        if(!pushAbstractState(&queue[current], &count[current], &capacity[current], next))
+                            goto cleanup;
+                    }
+                }
+            }
+
+            for(i = 0; i < tileCount; ++i) {
+                occupant[cells[i]] = 0;
+            }
+        }
+
+        count[current] = 0;
+        current = !current;
+        ++level;
+    }
+
+    //the blank may be anywhere, so a placement costs the least over all blank cells
+    for(rank = 0; rank < placements; ++rank) {
+        database->distance[rank] = UNREACHED_COST;
+        for(blank = 0; blank < BOARD_SIZE; ++blank) {
+            if(cost[rank * BOARD_SIZE + blank] < database->distance[rank])
+                database->distance[rank] = cost[rank * BOARD_SIZE + blank];
+        }
+    }
+    success = 1;
+
+cleanup:
+    free(cost);
+    free(queue[0]);
+    free(queue[1]);
+    if(!success) {
+        free(database->distance);
+        database->distance = NULL;
+    }
+    return success;
+}
+
+/**
+ * DESCRIPTION: What `recordPatternCost()` fills a group's database with.
+**/
+typedef struct PatternRecorder {
+    PatternDatabase *database; //the database filled
+    unsigned char member[MAX_BOARD_SIZE]; //1 + the index of each symbol in the group, or 0
+} PatternRecorder;
+
+/**
+ * DESCRIPTION:
+ *    The `LevelVisitor` of an external pattern database build. Levels come in
+ *    order of cost, so the first cost a placement is met at is its lowest over
+ *    all blank cells.
+**/
+char recordPatternCost(void *data, Board board, unsigned int level) {
+    PatternRecorder *recorder = data;
+    unsigned char cells[MAX_BOARD_SIZE];
+    unsigned int cell, member;
+    uint64_t rank;
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        if((member = recorder->member[getTile(board, cell)]))
+            cells[member - 1] = cell;
+    }
+
+    rank = rankPlacement(cells, recorder->database->tileCount);
+    if(recorder->database->distance[rank] == UNREACHED_COST)
+        recorder->database->distance[rank] = level;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds the distances of a group as `buildPatternDatabase()` does, but
+ *    with the breadth-first search run on disk by `enumerateLevels()`, its
+ *    abstract states being the boards with the tiles of other groups masked.
+ *    Only the database itself is held in memory, along with the successors
+ *    sorted at once, so groups whose abstract states do not fit in memory can
+ *    be built.
+ * PARAMETERS:
+ *    database - the group to build; its tiles must be set
+ *    goal     - the goal state
+ *    options  - where and with how much memory the search runs
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char buildExternalPatternDatabase(PatternDatabase * const database, State const *goal,
+        ExternalOptions const *options) {
+    ExternalSearch search;
+    PatternRecorder recorder;
+    unsigned int i;
+
+    database->size = countPlacements(database->tileCount);
+    database->distance = malloc(database->size);
+    if(!database->distance)
+        return 0;
+    memset(database->distance, UNREACHED_COST, database->size);
+
+    initExternalSearch(&search, options);
+    memset(search.isKept + 1, 0, sizeof(search.isKept) - 1);
+    memset(recorder.member, 0, sizeof(recorder.member));
+    for(i = 0; i < database->tileCount; ++i) {
+        search.isKept[database->tiles[i]] = 1;
+        recorder.member[database->tiles[i]] = i + 1;
+    }
+    recorder.database = database;
+    search.visit = recordPatternCost;
+    search.data = &recorder;
+
+    if(!enumerateLevels(&search, goal)) {
+        free(database->distance);
+        database->distance = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This adds a group of tiles to `patterns`. Its database is not built yet.
+ * PARAMETERS:
+ *    patterns  - the pattern databases to add the group to
+ *    tiles     - the tiles of the group; the blank is not allowed
+ *    tileCount - number of tiles in the group
+ *    partition - the partition the group belongs to; groups of one partition
+ *                must be disjoint
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char addPatternGroup(PatternHeuristic * const patterns, unsigned char const *tiles,
+        unsigned int tileCount, unsigned int partition) {
+    if(patterns->groupCount == MAX_PATTERN_GROUPS || tileCount == 0 || tileCount >= BOARD_SIZE)
+        return 0;
+
+    PatternDatabase *database = &patterns->groups[patterns->groupCount];
+    unsigned int cell;
+
+    database->partition = partition;
+    database->tileCount = tileCount;
+    memcpy(database->tiles, tiles, tileCount);
+    database->source = patterns->groupCount++;
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        database->cellMap[cell] = cell;
+    }
+    database->size = 0;
+    database->distance = NULL;
+
+    if(partition >= patterns->partitionCount)
+        patterns->partitionCount = partition + 1;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This lets every group of `patterns` that a symmetry of the goal carries an
+ *    earlier group onto use that group's database. The group's tiles are
+ *    reordered as the images of the earlier group's, so that both rank their
+ *    placements alike.
+**/
+void shareSymmetricGroups(PatternHeuristic * const patterns) {
+    SymmetryGroup group;
+    Symmetry const *symmetry;
+    PatternDatabase *database, *source;
+    unsigned char isMember[MAX_BOARD_SIZE];
+    unsigned int i, j, s, k, cell;
+
+    buildSymmetryGroup(&patterns->goal, &group);
+
+    for(i = 1; i < patterns->groupCount; ++i) {
+        database = &patterns->groups[i];
+        memset(isMember, 0, sizeof(isMember));
+        for(k = 0; k < database->tileCount; ++k) {
+            isMember[database->tiles[k]] = 1;
+        }
+
+        for(j = 0; j < i && database->source == i; ++j) {
+            source = &patterns->groups[j];
+            if(source->source != j || source->tileCount != database->tileCount)
+                continue;
+
+            for(s = 1; s < group.count; ++s) {
+                symmetry = &group.symmetries[s];
+                for(k = 0; k < source->tileCount && isMember[symmetry->label[source->tiles[k]]]; ++k);
+                if(k < source->tileCount)
+                    continue;
+
+                //a tile in cell `c` is looked up as its preimage, in the preimage of `c`
+                for(k = 0; k < source->tileCount; ++k) {
+                    database->tiles[k] = symmetry->label[source->tiles[k]];
+                }
+                for(cell = 0; cell < BOARD_SIZE; ++cell) {
+                    database->cellMap[symmetry->cell[cell]] = cell;
+                }
+                database->source = j;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This sets up `patterns` for `goal` with the default partition: the tiles in
+ *    the order of their goal cells, split into groups of PATTERN_GROUP_SIZE, so
+ *    that each group is made of neighboring tiles. Groups that are images of
+ *    one another share a database. No database is built yet.
+**/
+void initPatternHeuristic(PatternHeuristic * const patterns, State const *goal) {
+    unsigned char tiles[MAX_BOARD_SIZE];
+    unsigned int cell, tileCount = 0;
+
+    patterns->goal = *goal;
+    patterns->groupCount = 0;
+    patterns->partitionCount = 0;
+    patterns->mapping = NULL;
+    patterns->mappingSize = 0;
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        if(getTile(goal->board, cell) != BLANK_SYMBOL)
+            tiles[tileCount++] = getTile(goal->board, cell);
+    }
+
+    for(cell = 0; cell < tileCount; cell += PATTERN_GROUP_SIZE) {
+        addPatternGroup(patterns, tiles + cell,
+            tileCount - cell < PATTERN_GROUP_SIZE? tileCount - cell : PATTERN_GROUP_SIZE, 0);
+    }
+    shareSymmetricGroups(patterns);
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds the database of every group of `patterns`, in memory or, if
+ *    `external` is not NULL, on disk.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char buildPatternHeuristic(PatternHeuristic * const patterns, ExternalOptions const *external) {
+    unsigned int i;
+
+    for(i = 0; i < patterns->groupCount; ++i) {
+        if(patterns->groups[i].source != i)
+            continue;
+        if(external? !buildExternalPatternDatabase(&patterns->groups[i], &patterns->goal, external)
+                : !buildPatternDatabase(&patterns->groups[i], &patterns->goal))
+            return 0;
+    }
+
+    //the sources come first, so they are all built by now
+    for(i = 0; i < patterns->groupCount; ++i) {
+        patterns->groups[i].size = patterns->groups[patterns->groups[i].source].size;
+        patterns->groups[i].distance = patterns->groups[patterns->groups[i].source].distance;
+    }
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This writes the databases of `patterns` to a file, to be mapped back by
+ *    `loadPatternHeuristic()`.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char savePatternHeuristic(PatternHeuristic const *patterns, char const *path) {
+    PatternFileHeader header = { PATTERN_FILE_MAGIC, BOARD_ROWS, BOARD_COLS,
+        patterns->groupCount, patterns->partitionCount, { 0 } };
+    PatternFileGroup group;
+    unsigned int i;
+    char success = 1;
+    FILE *file = fopen(path, "wb");
+
+    if(!file)
+        return 0;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        header.goal[i] = getTile(patterns->goal.board, i);
+    }
+    success &= fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for(i = 0; i < patterns->groupCount; ++i) {
+        memset(&group, 0, sizeof(group));
+        group.partition = patterns->groups[i].partition;
+        group.tileCount = patterns->groups[i].tileCount;
+        memcpy(group.tiles, patterns->groups[i].tiles, group.tileCount);
+        group.source = patterns->groups[i].source;
+        memcpy(group.cellMap, patterns->groups[i].cellMap, BOARD_SIZE);
+        group.size = patterns->groups[i].size;
+        success &= fwrite(&group, sizeof(group), 1, file) == 1;
+    }
+
+    for(i = 0; i < patterns->groupCount; ++i) {
+        if(patterns->groups[i].source == i)
+            success &= fwrite(patterns->groups[i].distance, 1, patterns->groups[i].size, file)
+                == patterns->groups[i].size;
+    }
+
+    success &= fclose(file) == 0;
+    return success;
+}
+
+/**
+ * DESCRIPTION:
+ *    This maps the databases written by `savePatternHeuristic()` into memory. The
+ *    distances are used straight from the mapping, without being copied.
+ * PARAMETERS:
+ *    patterns - where the databases are loaded into
+ *    path     - the file to load
+ *    goal     - the goal state the databases must have been built for
+ * RETURN:
+ *    Returns 1 on success; 0 if the file cannot be read, is corrupt, or was built
+ *    for another board size or goal.
+**/
+char loadPatternHeuristic(PatternHeuristic * const patterns, char const *path, State const *goal) {
+    size_t size;
+    unsigned char *contents = mapFile(path, &size);
+    PatternFileHeader const *header = (PatternFileHeader const *)contents;
+    PatternFileGroup const *group;
+    size_t offset;
+    unsigned int i, cell;
+
+    if(!contents)
+        return 0;
+
+    if(size < sizeof(PatternFileHeader) || memcmp(header->magic, PATTERN_FILE_MAGIC, sizeof(header->magic))
+            || header->rows != BOARD_ROWS || header->cols != BOARD_COLS
+            || header->groupCount > MAX_PATTERN_GROUPS || header->partitionCount > MAX_PATTERN_GROUPS
+            || size < sizeof(PatternFileHeader) + header->groupCount * sizeof(PatternFileGroup))
+        goto invalid;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        if(header->goal[i] != getTile(goal->board, i))
+            goto invalid;
+    }
+
+    patterns->goal = *goal;
+    patterns->groupCount = header->groupCount;
+    patterns->partitionCount = header->partitionCount;
+    patterns->mapping = contents;
+    patterns->mappingSize = size;
+
+    group = (PatternFileGroup const *)(header + 1);
+    offset = sizeof(PatternFileHeader) + header->groupCount * sizeof(PatternFileGroup);
+
+    for(i = 0; i < patterns->groupCount; ++i, ++group) {
+        if(group->tileCount >= BOARD_SIZE || group->size != countPlacements(group->tileCount)
+                || group->partition >= header->partitionCount
+                || group->source > i || (group->source == i && size - offset < group->size)
+                || (group->source < i && (patterns->groups[group->source].source != group->source
+                    || patterns->groups[group->source].tileCount != group->tileCount)))
+            goto invalid;
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            if(group->cellMap[cell] >= BOARD_SIZE)
+                goto invalid;
+        }
+        for(cell = 0; cell < group->tileCount; ++cell) {
+            if(group->tiles[cell] >= BOARD_SIZE)
+                goto invalid;
+        }
+
+        patterns->groups[i].partition = group->partition;
+        patterns->groups[i].tileCount = group->tileCount;
+        memcpy(patterns->groups[i].tiles, group->tiles, MAX_BOARD_SIZE);
+        patterns->groups[i].source = group->source;
+        memcpy(patterns->groups[i].cellMap, group->cellMap, MAX_BOARD_SIZE);
+        patterns->groups[i].size = group->size;
+        if(group->source == i) {
+            patterns->groups[i].distance = contents + offset;
+            offset += group->size;
+        }
+        else {
+            patterns->groups[i].distance = patterns->groups[group->source].distance;
+        }
+    }
+    return 1;
+
+invalid:
+    unmapFile(contents, size);
+    patterns->groupCount = 0;
+    patterns->mapping = NULL;
+    patterns->mappingSize = 0;
+    return 0;
+}
+
+/**
+ * DESCRIPTION: This releases the databases of `patterns`.
+**/
+void destroyPatternHeuristic(PatternHeuristic * const patterns) {
+    unsigned int i;
+
+    if(patterns->mapping) {
+        unmapFile(patterns->mapping, patterns->mappingSize);
+    }
+    else {
+        for(i = 0; i < patterns->groupCount; ++i) {
+            if(patterns->groups[i].source == i)
+                free(patterns->groups[i].distance);
+        }
+    }
+
+    patterns->groupCount = 0;
+    patterns->mapping = NULL;
+    patterns->mappingSize = 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This maps the databases of `goal` from `path`, or builds them and saves them
+ *    to `path` if the file is missing or holds the databases of another goal.
+ *    They are built on disk if `external` is not NULL.
+ * RETURN:
+ *    Returns 1 on success, 0 if there is not enough memory or disk to build them.
+**/
+char preparePatternHeuristic(PatternHeuristic * const patterns, char const *path, State const *goal,
+        ExternalOptions const *external) {
+    if(loadPatternHeuristic(patterns, path, goal))
+        return 1;
+
+    fprintf(stderr, "Building pattern databases...\n");
+    initPatternHeuristic(patterns, goal);
+    if(!buildPatternHeuristic(patterns, external)) {
+        destroyPatternHeuristic(patterns);
+        return 0;
+    }
+    if(!savePatternHeuristic(patterns, path))
+        fprintf(stderr, "WARNING: Could not save the pattern databases to %s.\n", path);
+
+    return 1;
+}
+
+/**
+ * DESCRIPTION: The `evaluate` function of the pattern database heuristic.
+**/
+unsigned int patternEvaluate(void const *data, State const *state) {
+    PatternHeuristic const *patterns = data;
+    PatternDatabase const *database;
+    unsigned char cellOf[BOARD_SIZE];    //cell of each symbol of `state`
+    unsigned char cells[MAX_BOARD_SIZE]; //cells of a group's tiles
+    unsigned int sum[MAX_PATTERN_GROUPS] = { 0 };
+    unsigned int i, j, best = 0;
+    PROFILE_BEGIN(PHASE_HEURISTIC);
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        cellOf[getTile(state->board, i)] = i;
+    }
+
+    for(i = 0; i < patterns->groupCount; ++i) {
+        database = &patterns->groups[i];
+        for(j = 0; j < database->tileCount; ++j) {
+            cells[j] = database->cellMap[cellOf[database->tiles[j]]];
+        }
+        sum[database->partition] += database->distance[rankPlacement(cells, database->tileCount)];
+    }
+
+    for(i = 0; i < patterns->partitionCount; ++i) {
+        if(sum[i] > best)
+            best = sum[i];
+    }
+
+    PROFILE_END(PHASE_HEURISTIC);
+    return best;
+}
+
+/**
+ * DESCRIPTION:
+ *    The `update` function of the pattern database heuristic. Lookups are cheap
+ *    enough that the child is simply evaluated from scratch.
+**/
+unsigned int patternUpdate(void const *data, State const *parent, State const *child, unsigned int hCost) {
+    (void)parent;
+    (void)hCost;
+    return patternEvaluate(data, child);
+}
+
+/**
+ * DESCRIPTION:
+ *    This sets up `heuristic` as the lookups of `patterns`, which must be built or
+ *    loaded and must outlive the heuristic.
+**/
+void usePatternDatabases(Heuristic * const heuristic, PatternHeuristic const *patterns) {
+    heuristic->evaluate = patternEvaluate;
+    heuristic->update = patternUpdate;
+    heuristic->data = patterns;
+}
@@ -0,0 +1,227 @@
+#include<pthread.h>
+#ifdef _WIN32
+#include<windows.h>
+#else
+#include<unistd.h>
+#endif
+
+/**
+ * DESCRIPTION:
+ *    A fixed pool of worker threads that run a batch of independent tasks, each
+ *    identified by its index. Every worker owns a search context and a deque of
+ *    task indices: it takes tasks from the bottom of its own deque, and once that
+ *    is empty it steals from the top of the others'. Tasks are dealt to the deques
+ *    in contiguous ranges, so a deque is simply the range of indices it has left.
+**/
+
+//the function a task runs; `context` belongs to the worker running it
+typedef void (*PoolTask)(void *data, unsigned int index, SearchContext *context);
+
+/**
+ * DESCRIPTION: The tasks a worker has left, i.e. the indices in [top, bottom).
+**/
+typedef struct WorkDeque {
+    pthread_mutex_t lock;      //guards `top` and `bottom`
+    unsigned int top;          //the index thieves take next
+    unsigned int bottom;       //one past the index the owner takes next
+} WorkDeque;
+
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * DESCRIPTION: A worker thread of the pool.
+**/
+typedef struct Worker {
+    pthread_t thread;          //the thread running `workerMain()`
+    ThreadPool *pool;          //the pool the worker belongs to
+    unsigned int id;           //index of the worker in the pool
+    WorkDeque deque;           //the tasks dealt to, or left to, this worker
+    SearchContext context;     //the context every task of this worker runs in
+} Worker;
+
+struct ThreadPool {
+    unsigned int workerCount;  //number of workers
+    Worker *workers;           //the workers
+    PoolTask task;             //the function of the current batch
+    void *data;                //the data of the current batch
+    pthread_mutex_t lock;      //guards the fields below
+    pthread_cond_t started;    //signaled when a batch starts or the pool stops
+    pthread_cond_t finished;   //signaled when the last worker runs out of tasks
+    unsigned int generation;   //number of batches started so far
+    unsigned int running;      //number of workers still working on the batch
+    char isStopping;           //set when the workers must exit
+};
+
+/**
+ * DESCRIPTION:
+ *    This takes the next task of `worker`, from its own deque first and then
+ *    from the other workers' deques, visited round-robin.
+ * RETURN:
+ *    Returns 1 if `index` is written, 0 if every deque is empty.
+**/
+char takeTask(Worker * const worker, unsigned int * const index) {
+    ThreadPool *pool = worker->pool;
+    WorkDeque *deque = &worker->deque;
+    unsigned int i;
+    char found = 0;
+
+    pthread_mutex_lock(&deque->lock);
+    if(deque->top < deque->bottom) {
+        *index = --deque->bottom;
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+
+    //since no task spawns others, one pass over empty deques means the batch is done
+    for(i = 1; !found && i < pool->workerCount; ++i) {
+        deque = &pool->workers[(worker->id + i) % pool->workerCount].deque;
+
+        pthread_mutex_lock(&deque->lock);
+        if(deque->top < deque->bottom) {
+            *index = deque->top++;
+            found = 1;
+        }
+        pthread_mutex_unlock(&deque->lock);
+    }
+
+    return found;
+}
+
+/**
+ * DESCRIPTION: The body of each worker thread: it runs batches until the pool stops.
+**/
+void* workerMain(void *argument) {
+    Worker *worker = argument;
+    ThreadPool *pool = worker->pool;
+    unsigned int generation = 0;
+    unsigned int index;
+
+    for(;;) {
+        //wait for the next batch
+        pthread_mutex_lock(&pool->lock);
+        while(pool->generation == generation && !pool->isStopping) {
+            pthread_cond_wait(&pool->started, &pool->lock);
+        }
+        if(pool->isStopping) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        while(takeTask(worker, &index)) {
+            pool->task(pool->data, index, &worker->context);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if(--pool->running == 0)
+            pthread_cond_signal(&pool->finished);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This starts a pool of `workerCount` threads, which wait for `runPool()`.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char createPool(ThreadPool * const pool, unsigned int workerCount) {
+    unsigned int i;
+
+    pool->workers = calloc(workerCount, sizeof(Worker));
+    if(!pool->workers)
+        return 0;
+
+    pool->workerCount = 0;
+    pool->generation = 0;
+    pool->running = 0;
+    pool->isStopping = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->started, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+
+    for(i = 0; i < workerCount; ++i) {
+        Worker *worker = &pool->workers[i];
+
+        worker->pool = pool;
+        worker->id = i;
+        pthread_mutex_init(&worker->deque.lock, NULL);
+        initSearchContext(&worker->context);
+
+        if(pthread_create(&worker->thread, NULL, workerMain, worker)) {
+            pthread_mutex_destroy(&worker->deque.lock);
+            break;
+        }
+        ++pool->workerCount;
+    }
+
+    //run with the threads that could be started
+    return pool->workerCount > 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This runs `task` for every index in [0, taskCount) on the workers of `pool`,
+ *    and returns once all of them are done.
+**/
+void runPool(ThreadPool * const pool, unsigned int taskCount, PoolTask task, void *data) {
+    unsigned int i;
+
+    //deal contiguous ranges of tasks to the deques
+    for(i = 0; i < pool->workerCount; ++i) {
+        pool->workers[i].deque.top = (unsigned long)taskCount * i / pool->workerCount;
+        pool->workers[i].deque.bottom = (unsigned long)taskCount * (i + 1) / pool->workerCount;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->data = data;
+    pool->running = pool->workerCount;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->started);
+
+    while(pool->running > 0) {
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * DESCRIPTION: This stops the workers of `pool` and releases their contexts.
+**/
+void destroyPool(ThreadPool * const pool) {
+    unsigned int i;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->isStopping = 1;
+    pthread_cond_broadcast(&pool->started);
+    pthread_mutex_unlock(&pool->lock);
+
+    for(i = 0; i < pool->workerCount; ++i) {
+        pthread_join(pool->workers[i].thread, NULL);
+        pthread_mutex_destroy(&pool->workers[i].deque.lock);
+        destroySearchContext(&pool->workers[i].context);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->started);
+    pthread_cond_destroy(&pool->finished);
+    free(pool->workers);
+    pool->workers = NULL;
+    pool->workerCount = 0;
+}
+
+/**
+ * DESCRIPTION: This counts the processors available to the process.
+**/
+unsigned int countProcessors(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0? (unsigned int)count : 1;
+#endif
+}
@@ -0,0 +1,189 @@
+/**
+ * DESCRIPTION:
+ *    Opt-in instrumentation of the hot paths of the searches. When compiled with
+ *    -DENABLE_PROFILING, every search records the time spent in and the number of
+ *    calls to each phase below, the distribution of the open list size and of the
+ *    f-cost of the nodes it expands, and a timeline of both, and writes them as
+ *    one JSON object to `profileOutput` when it ends. Without the flag, every
+ *    macro of this file expands to nothing and the searches are left untouched.
+ *
+ *    Phases nest: the time of PHASE_EXPANSION includes the move generation,
+ *    heuristic evaluations and duplicate checks done for the children.
+**/
+
+//this enumerates the instrumented phases
+typedef enum ProfilePhase {
+    PHASE_MOVE_GENERATION,     //createState()
+    PHASE_EXPANSION,           //getChildren()
+    PHASE_HEURISTIC,           //the `evaluate` and `update` functions of the heuristics
+    PHASE_OPEN_PUSH,           //pushes to the open list or queue
+    PHASE_OPEN_POP,            //pops from the open list or queue
+    PHASE_DUPLICATE_CHECK,     //updateClosedSet()
+    PHASE_TEARDOWN,            //destroyHeap() and destroyQueue()
+    PROFILE_PHASES
+} ProfilePhase;
+
+#ifdef ENABLE_PROFILING
+
+#define PROFILE_BUCKETS 32        //buckets of each histogram
+#define PROFILE_MAX_SAMPLES 256   //entries of the timeline
+#define PROFILE_SAMPLE_INTERVAL 1 //initial number of expansions between timeline entries
+
+static char const *phaseNames[PROFILE_PHASES] = {
+    "moveGeneration", "expansion", "heuristic", "openPush", "openPop", "duplicateCheck", "teardown"
+};
+
+/**
+ * DESCRIPTION: The measurements of a single search.
+**/
+typedef struct Profile {
+    uint64_t calls[PROFILE_PHASES];                  //number of calls to each phase
+    uint64_t nanoseconds[PROFILE_PHASES];            //time spent in each phase
+    uint64_t openSizes[PROFILE_BUCKETS];             //expansions by open list size, in powers of 2
+    uint64_t fCosts[PROFILE_BUCKETS];                //expansions by f-cost, in steps of 4
+    uint64_t expansions;                             //number of samples taken
+    uint64_t sampleInterval;                         //expansions between timeline entries
+    unsigned int sampleCount;                        //number of timeline entries
+    uint32_t timeline[PROFILE_MAX_SAMPLES][3];       //expansions, open list size and f-cost
+} Profile;
+
+//where the profile of each search is written to; the standard error if NULL
+static FILE *profileOutput;
+
+//the profile of the search running on the current thread, if any
+static _Thread_local Profile *activeProfile;
+
+/**
+ * DESCRIPTION: This reads the monotonic clock, in nanoseconds.
+**/
+static inline uint64_t profileClock(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/**
+ * DESCRIPTION:
+ *    This clears `profile` and makes it the profile of the searches on the
+ *    current thread.
+**/
+void startProfile(Profile * const profile) {
+    memset(profile, 0, sizeof(Profile));
+    profile->sampleInterval = PROFILE_SAMPLE_INTERVAL;
+    activeProfile = profile;
+}
+
+/**
+ * DESCRIPTION:
+ *    This stops recording into `profile` on the current thread, if the searches
+ *    there record into it, so that nothing run after the search is counted in
+ *    its profile and no search context is written to once it is destroyed.
+**/
+void stopProfile(Profile const *profile) {
+    if(activeProfile == profile)
+        activeProfile = NULL;
+}
+
+/**
+ * DESCRIPTION: This records a call to `phase` that started at `start`.
+**/
+static inline void recordPhase(ProfilePhase phase, uint64_t start) {
+    if(activeProfile) {
+        ++activeProfile->calls[phase];
+        activeProfile->nanoseconds[phase] += profileClock() - start;
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This records the expansion of a node of total cost `fCost` while `openSize`
+ *    nodes are waiting. Once the timeline is full, every other entry is dropped
+ *    and entries are taken half as often, so it always spans the whole search.
+**/
+void recordExpansion(uint64_t openSize, unsigned int fCost) {
+    Profile *profile = activeProfile;
+    unsigned int bucket = 0, i;
+
+    if(!profile)
+        return;
+
+    while(bucket + 1 < PROFILE_BUCKETS && openSize >> bucket > 1)
+        ++bucket;
+    ++profile->openSizes[bucket];
+    ++profile->fCosts[fCost / 4 < PROFILE_BUCKETS? fCost / 4 : PROFILE_BUCKETS - 1];
+
+    if(profile->expansions++ % profile->sampleInterval == 0) {
+        if(profile->sampleCount == PROFILE_MAX_SAMPLES) {
+            for(i = 0; i < PROFILE_MAX_SAMPLES / 2; ++i) {
+                memcpy(profile->timeline[i], profile->timeline[2 * i], sizeof(profile->timeline[i]));
+            }
+            profile->sampleCount = PROFILE_MAX_SAMPLES / 2;
+            profile->sampleInterval *= 2;
+        }
+
+        profile->timeline[profile->sampleCount][0] = profile->expansions - 1;
+        profile->timeline[profile->sampleCount][1] = openSize;
+        profile->timeline[profile->sampleCount][2] = fCost;
+        ++profile->sampleCount;
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This writes `profile` as a JSON object on a single line, and stops
+ *    recording into it.
+**/
+void dumpProfile(Profile const *profile, char const *engine) {
+    FILE *file = profileOutput? profileOutput : stderr;
+    unsigned int i;
+
+    fprintf(file, "{\"engine\": \"%s\", \"phases\": {", engine);
+    for(i = 0; i < PROFILE_PHASES; ++i) {
+        fprintf(file, "%s\"%s\": {\"calls\": %llu, \"ns\": %llu}", i? ", " : "", phaseNames[i],
+            (unsigned long long)profile->calls[i], (unsigned long long)profile->nanoseconds[i]);
+    }
+
+    fprintf(file, "}, \"openSizeLog2\": [");
+    for(i = 0; i < PROFILE_BUCKETS; ++i) {
+        fprintf(file, "%s%llu", i? ", " : "", (unsigned long long)profile->openSizes[i]);
+    }
+
+    fprintf(file, "], \"fCostBy4\": [");
+    for(i = 0; i < PROFILE_BUCKETS; ++i) {
+        fprintf(file, "%s%llu", i? ", " : "", (unsigned long long)profile->fCosts[i]);
+    }
+
+    fprintf(file, "], \"timeline\": [");
+    for(i = 0; i < profile->sampleCount; ++i) {
+        fprintf(file, "%s[%u, %u, %u]", i? ", " : "", profile->timeline[i][0], profile->timeline[i][1],
+            profile->timeline[i][2]);
+    }
+    fprintf(file, "]}\n");
+    stopProfile(profile);
+}
+
+//times the code up to the matching PROFILE_END() as a call to `phase`
+#define PROFILE_BEGIN(phase) uint64_t profileStart_##phase = profileClock()
+#define PROFILE_END(phase) recordPhase(phase, profileStart_##phase)
+
+//records the expansion of a node, for the histograms and the timeline
+#define PROFILE_EXPANSION(openSize, fCost) recordExpansion(openSize, fCost)
+
+//the profile member of `SearchContext`, and the hooks of the start and end of a search
+#define PROFILE_MEMBER Profile profile;
+#define PROFILE_START(context) startProfile(&(context)->profile)
+#define PROFILE_DUMP(context, engine) dumpProfile(&(context)->profile, engine)
+#define PROFILE_STOP(context) stopProfile(&(context)->profile)
+
+#else
+
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#define PROFILE_EXPANSION(openSize, fCost)
+#define PROFILE_MEMBER
+#define PROFILE_START(context)
+#define PROFILE_DUMP(context, engine)
+#define PROFILE_STOP(context)
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * DESCRIPTION:
+ *    The solver library: the implementation of the API of `puzzle.h`. This is
+ *    the one translation unit the engines' headers are compiled into for the
+ *    library, as `main.c` is for the solver, and is built into `libpuzzle.a`
+ *    with `make lib`.
+**/
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdint.h>
+#include<string.h>
+#include<time.h>
+#include<limits.h>
+
+#include "profile.h"
+#include "state.h"
+#include "closed.h"
+#include "context.h"
+#include "heuristic.h"
+#include "node.h"
+#include "list.h"
+#include "heap.h"
+#include "io.h"
+#include "mapfile.h"
+#include "external.h"
+#include "pdb.h"
+#include "walking.h"
+#include "search.h"
+#include "table.h"
+#include "pool.h"
+#include "parallel.h"
+#include "hda.h"
+#include "sma.h"
+#include "cache.h"
+#include "batch.h"
+#include "puzzle.h"
+
+/**
+ * DESCRIPTION:
+ *    A solver handle. Everything a search sets up before it can start is kept
+ *    here between calls: the closed set in the search context, the heuristic's
+ *    tables for the last goal, and the distance table. Solutions are kept too,
+ *    in the cache.
+**/
+struct PuzzleSolver {
+    Engine engine;             //the engine of every instance
+    AnytimeOptions anytime;    //the weight and time limit of weighted and anytime A*
+    unsigned int threadCount;  //the number of threads of HDA*
+    size_t memoryLimit;        //the bytes each search may hold
+    SearchContext context;     //statistics of the last search, and the closed set
+    GoalHeuristic heuristic;   //the heuristic and its tables
+    char const *tablePath;     //file of the distance table; NULL for none
+    char hasTable;             //set once `table` is loaded or built
+    DistanceTable table;       //the distance table, once prepared
+    char hasCache;             //set if `cache` is in use
+    SolutionCache cache;       //solutions of earlier instances
+};
+
+void puzzleDefaultOptions(PuzzleOptions *options) {
+    options->engine = PUZZLE_ASTAR;
+    options->heuristic = PUZZLE_MANHATTAN;
+    options->pdbPath = NULL;
+    options->tablePath = NULL;
+    options->weight = ANYTIME_WEIGHT;
+    options->timeLimit = 0;
+    options->threadCount = countProcessors();
+    options->cacheSize = 0;
+    options->memoryLimit = DEFAULT_EXTERNAL_MEMORY;
+}
+
+void puzzleBoardSize(unsigned int *rows, unsigned int *cols) {
+    *rows = BOARD_ROWS;
+    *cols = BOARD_COLS;
+}
+
+PuzzleSolver* puzzleCreate(PuzzleOptions const *options) {
+    static const Engine engines[] = {
+        ENGINE_ASTAR, ENGINE_IDASTAR, ENGINE_BFS, ENGINE_BIDIRECTIONAL, ENGINE_WEIGHTED, ENGINE_ANYTIME, ENGINE_HDA,
+        ENGINE_SMA
+    };
+    static const HeuristicKind heuristics[] = { HEURISTIC_MANHATTAN, HEURISTIC_CONFLICT, HEURISTIC_WALKING };
+    PuzzleSolver *solver;
+
+    if((unsigned int)options->engine >= sizeof(engines) / sizeof(engines[0])
+            || (unsigned int)options->heuristic >= sizeof(heuristics) / sizeof(heuristics[0]))
+        return NULL;
+
+    solver = malloc(sizeof(PuzzleSolver));
+    if(!solver)
+        return NULL;
+
+    solver->engine = engines[options->engine];
+    solver->anytime.weight = options->weight >= 1? options->weight : ANYTIME_WEIGHT;
+    solver->anytime.weightStep = ANYTIME_WEIGHT_STEP;
+    solver->anytime.timeLimit = options->timeLimit;
+    solver->anytime.report = NULL;
+    solver->anytime.data = NULL;
+    solver->threadCount = options->threadCount;
+    solver->memoryLimit = options->memoryLimit? options->memoryLimit : DEFAULT_EXTERNAL_MEMORY;
+    solver->tablePath = options->tablePath;
+    solver->hasTable = 0;
+    solver->hasCache = options->cacheSize > 0;
+
+    if(solver->hasCache && !createSolutionCache(&solver->cache, options->cacheSize)) {
+        free(solver);
+        return NULL;
+    }
+
+    initSearchContext(&solver->context);
+    initGoalHeuristic(&solver->heuristic, options->pdbPath? HEURISTIC_PATTERN : heuristics[options->heuristic],
+        options->pdbPath);
+    return solver;
+}
+
+PuzzleStatus puzzleSolve(PuzzleSolver *solver, char const *initial, char const *goal, char *moves, size_t size,
+        PuzzleResult *result) {
+    static const char letter[4] = { 'U', 'D', 'L', 'R' };
+    State initialState, goalState;
+    Heuristic const *heuristic;
+    SolutionPath *path, *step;
+    size_t i = 0;
+
+    memset(result, 0, sizeof(PuzzleResult));
+    if(moves && size)
+        moves[0] = '\0';
+
+    if(!parseState(&initial, &initialState) || *initial || !parseState(&goal, &goalState) || *goal)
+        return result->status = PUZZLE_INVALID;
+
+    if(!prepareGoalHeuristic(&solver->heuristic, &goalState, &heuristic))
+        return result->status = PUZZLE_FAILED;
+
+    //the table is prepared once, for the goal of the first instance if the file holds none
+    if(solver->tablePath && !solver->hasTable) {
+        solver->hasTable = loadDistanceTable(&solver->table, solver->tablePath, NULL)
+            || prepareDistanceTable(&solver->table, solver->tablePath, &goalState);
+        if(!solver->hasTable)
+            solver->tablePath = NULL;
+    }
+
+    path = solveInstance(solver->engine, &solver->context, &initialState, &goalState, heuristic,
+        solver->hasTable? &solver->table : NULL, solver->hasCache? &solver->cache : NULL, solver->threadCount, &solver->anytime,
+        solver->memoryLimit);
+    PROFILE_STOP(&solver->context);
+
+    result->length = solver->context.stats.solutionLength;
+    result->expanded = solver->context.stats.nodesExpanded;
+    result->generated = solver->context.stats.nodesGenerated;
+    result->runtime = solver->context.stats.runtime;
+    result->cacheHits = solver->context.stats.cacheHits;
+    result->cacheMisses = solver->context.stats.cacheMisses;
+
+    //skip the first node, which holds the initial state
+    if(moves && size) {
+        for(step = path? path->next : NULL; step && i + 1 < size; step = step->next) {
+            moves[i++] = letter[step->action];
+        }
+        moves[i] = '\0';
+    }
+
+    result->status = path? PUZZLE_SOLVED : solver->context.stats.isUnsolvable? PUZZLE_UNSOLVABLE : PUZZLE_FAILED;
+    destroySolution(&path);
+    return result->status;
+}
+
+void puzzleDestroy(PuzzleSolver *solver) {
+    if(!solver)
+        return;
+
+    destroyGoalHeuristic(&solver->heuristic);
+    if(solver->hasTable)
+        destroyDistanceTable(&solver->table);
+    if(solver->hasCache)
+        destroySolutionCache(&solver->cache);
+    destroySearchContext(&solver->context);
+    free(solver);
+}
@@ -0,0 +1,135 @@
+/**
+ * DESCRIPTION:
+ *    The C API of the solver library, `libpuzzle.a`. It is the only header a
+ *    program embedding the solver includes; the search engines stay behind an
+ *    opaque handle. A handle is created once, and keeps its closed set, its
+ *    heuristic tables, its distance table and its solution cache from one call to
+ *    the next, so that a program solving many instances pays for their setup only
+ *    once (and again only when the goal changes). A handle may only be used by
+ *    one thread at a time; threads solving concurrently each create their own.
+ *
+ *    The board dimensions are fixed when the library is compiled, as for the
+ *    solver itself; `puzzleBoardSize()` tells them.
+**/
+#ifndef PUZZLE_H
+#define PUZZLE_H
+
+#include<stddef.h>
+
+#define PUZZLE_API_VERSION 4 //raised whenever a declaration of this file changes
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//this enumerates the search engines of a handle
+typedef enum PuzzleEngine {
+    PUZZLE_ASTAR, PUZZLE_IDASTAR, PUZZLE_BFS, PUZZLE_BIDIRECTIONAL, PUZZLE_WEIGHTED, PUZZLE_ANYTIME, PUZZLE_HDA,
+    PUZZLE_SMA
+} PuzzleEngine;
+
+//this enumerates the heuristics of the engines that take one
+typedef enum PuzzleHeuristic {
+    PUZZLE_MANHATTAN, PUZZLE_CONFLICT, PUZZLE_WALKING
+} PuzzleHeuristic;
+
+//this enumerates the outcomes of `puzzleSolve()`
+typedef enum PuzzleStatus {
+    PUZZLE_SOLVED,             //the solution is written
+    PUZZLE_UNSOLVABLE,         //the goal cannot be reached from the initial board
+    PUZZLE_INVALID,            //a board is not a permutation of the board's symbols
+    PUZZLE_FAILED              //the search gave up, e.g. out of time, out of memory even
+                               //within `memoryLimit`, or as the solution is longer than
+                               //254 moves (256 for IDA*, 255 for SMA*)
+} PuzzleStatus;
+
+/**
+ * DESCRIPTION: How a handle solves its instances; see `puzzleDefaultOptions()`.
+**/
+typedef struct PuzzleOptions {
+    PuzzleEngine engine;       //the search engine
+    PuzzleHeuristic heuristic; //the heuristic of A*, IDA*, weighted and anytime A*
+    char const *pdbPath;       //file of pattern databases to use instead of `heuristic`;
+                               //NULL for none. It is built and saved if missing
+    char const *tablePath;     //file of the distance table to look instances of its goal
+                               //up in; NULL for none. It is built and saved if missing
+    double weight;             //the weight of weighted A*, and the first of the anytime A*
+    double timeLimit;          //seconds after which the anytime A* returns its best
+                               //solution; 0 for none
+    unsigned int threadCount;  //the number of threads of HDA*, which solves each instance
+                               //with all of them
+    size_t cacheSize;          //number of solutions remembered, so that instances seen
+                               //before, or equal to one up to the names of their tiles,
+                               //are not searched again; 0 for none
+    size_t memoryLimit;        //bytes a search may hold. The other engines give up when
+                               //their open list or closed set would outgrow it, and the
+                               //memory-bounded A* then solves the instance within it
+} PuzzleOptions;
+
+/**
+ * DESCRIPTION: The outcome of one call to `puzzleSolve()`.
+**/
+typedef struct PuzzleResult {
+    PuzzleStatus status;       //the outcome
+    unsigned int length;       //number of moves of the solution
+    unsigned int expanded;     //nodes expanded by the search
+    unsigned int generated;    //nodes generated by the search
+    double runtime;            //time spent searching (in seconds)
+    unsigned long cacheHits;   //instances answered from the cache so far
+    unsigned long cacheMisses; //instances looked up in the cache and searched so far
+} PuzzleResult;
+
+typedef struct PuzzleSolver PuzzleSolver;
+
+/**
+ * DESCRIPTION: This fills `options` with A* guided by the Manhattan distance.
+**/
+void puzzleDefaultOptions(PuzzleOptions *options);
+
+/**
+ * DESCRIPTION:
+ *    This gives the board dimensions the library is compiled for. Boards are
+ *    written row by row, one symbol per cell: digits, then letters from 'A'
+ *    (10) onwards, with '0' for the blank, e.g. "123804765".
+**/
+void puzzleBoardSize(unsigned int *rows, unsigned int *cols);
+
+/**
+ * DESCRIPTION:
+ *    This creates a solver handle. The options are copied, but the strings they
+ *    point to must outlive the handle.
+ * RETURN:
+ *    Returns the handle; NULL if an option is out of range or memory runs out.
+**/
+PuzzleSolver* puzzleCreate(PuzzleOptions const *options);
+
+/**
+ * DESCRIPTION:
+ *    This solves one instance. Heuristic and distance tables are built on the
+ *    first instance of each goal and kept for the next ones, so instances are
+ *    best grouped by goal.
+ * PARAMETERS:
+ *    solver  - the handle to solve with
+ *    initial - the initial board
+ *    goal    - the goal board
+ *    moves   - where the solution is written as letters U, D, L and R, relative
+ *              to the blank, followed by a null character; may be NULL
+ *    size    - the number of bytes of `moves`. If the solution does not fit, only
+ *              its first moves are written; `result->length` tells its length
+ *    result  - where the outcome and the statistics of the search are written
+ * RETURN:
+ *    Returns `result->status`.
+**/
+PuzzleStatus puzzleSolve(PuzzleSolver *solver, char const *initial, char const *goal, char *moves, size_t size,
+    PuzzleResult *result);
+
+/**
+ * DESCRIPTION: This releases the handle and all of its tables. `solver` may be NULL.
+**/
+void puzzleDestroy(PuzzleSolver *solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,783 @@
+/**
+ * DESCRIPTION:
+ *    This is called by every search before it starts. Unsolvable puzzles are
+ *    rejected up front instead of exhausting the reachable half of the boards.
+ * RETURN:
+ *    Returns 1 if the search may proceed, 0 if `goal` is unreachable.
+**/
+char checkSolvable(SearchContext * const context, State const *initial, State const *goal) {
+    if(isSolvable(initial, goal))
+        return 1;
+
+    context->stats.isUnsolvable = 1;
+    return 0;
+}
+
+//reads the path cost recorded for `state`; UNVISITED_DEPTH if it was never reached
+typedef unsigned char (*DepthLookup)(void const *data, State const *state);
+
+/**
+ * DESCRIPTION:
+ *    This traces the solution back from `state` through the path costs recorded
+ *    for the boards reached, instead of through parent pointers. A board recorded
+ *    at cost k was reached from a neighbor then recorded at cost k - 1, and costs
+ *    only ever decrease, so some neighbor of every reached board but the initial
+ *    state holds a lower cost. Stepping to such a neighbor until the cost is 0
+ *    replays the moves backward, down to the initial state.
+ * PARAMETERS:
+ *    context - the search context to record the solution length in
+ *    lookup  - reads the path costs recorded by the search
+ *    data    - the tables `lookup` reads, e.g. the closed set of the search
+ *    state   - the state to trace the solution of, e.g. the goal state
+ * RETURN:
+ *    Returns the solution in a linked list, or NULL on failure.
+**/
+SolutionPath* traceDepthPath(SearchContext * const context, DepthLookup lookup, void const *data, State const *state) {
+    Move path[UNVISITED_DEPTH];    //the moves, from `state` back
+    State current = *state, neighbor;
+    unsigned char depth = lookup(data, state), known = 0;
+    unsigned int length = 0, i;
+    Move move;
+
+    while(depth > 0 && depth != UNVISITED_DEPTH) {
+        for(move = UP; move <= RIGHT; ++move) {
+            if(createState(&current, move, &neighbor) && (known = lookup(data, &neighbor)) < depth)
+                break;
+        }
+
+        if(move > RIGHT)
+            return NULL;
+
+        //`current` is reached from `neighbor` by undoing `move`
+        path[length++] = reverseMove[move];
+        current = neighbor;
+        depth = known;
+    }
+
+    if(depth)
+        return NULL;
+
+    //the moves were collected from the last one back
+    for(i = 0; i < length / 2; ++i) {
+        move = path[i];
+        path[i] = path[length - 1 - i];
+        path[length - 1 - i] = move;
+    }
+
+    context->stats.solutionLength = length;
+    return createSolution(path, length);
+}
+
+/**
+ * DESCRIPTION: The `DepthLookup` of a single closed set.
+**/
+unsigned char readDepth(void const *data, State const *state) {
+    return readClosedDepth(data, state);
+}
+
+/**
+ * DESCRIPTION: This traces the solution back from `state` through the closed set of the search.
+**/
+SolutionPath* traceClosedPath(SearchContext * const context, ClosedSet const *closed, State const *state) {
+    return traceDepthPath(context, readDepth, closed, state);
+}
+
+/**
+ * DESCRIPTION:
+ *    Our breadth-first search implemetation.
+ * PARAMETERS:
+ *    context - the search context to record statistics in
+ *    initial - address to the initial state
+ *    goal    - address to the goal state
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* BFS_search(SearchContext * const context, State *initial, State *goal) {
+    NodeQueue queue = { NULL, 0, 0, 0, &context->memoryLeft };
+    Node node, children[4];
+    SolutionPath *pathHead = NULL;
+    unsigned int childCount, i;
+    char isGoalFound = 0;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    //distances to the goal board, used for the heuristic values of every node
+    ManhattanTable distances;
+    Heuristic heuristic;
+    buildManhattanTable(goal, &distances);
+    useManhattan(&heuristic, &distances);
+
+    //boards already reached, so that they are not queued again; the solution is traced through it
+    ClosedSet *closed = acquireClosedSet(context);
+    if(!closed)
+        return NULL;
+    updateClosedSet(closed, initial, 0);
+
+    //initialize the queue with the root node of the search tree
+    createNode(context, 0, heuristic.evaluate(heuristic.data, initial), initial, &node);
+    if(!pushQueue(&node, &queue))
+        context->stats.isOutOfMemory = 1;
+
+    //while there is a node in the queue to expand, pop the oldest one
+    while(!context->stats.isOutOfMemory && popQueue(&queue, &node)) {
+        PROFILE_EXPANSION(queue.nodeCount, totalCost(&node));
+
+        //if the state of the node is the goal state
+        if(node.board == goal->board) {
+            isGoalFound = 1;
+            break;
+        }
+
+        //else, expand the node and update the expanded-nodes counter
+        childCount = getChildren(&node, &heuristic, closed, context, children);
+        ++context->stats.nodesExpanded;
+
+        //add the node's children to the queue; a search that runs out of memory gives up
+        for(i = 0; i < childCount; ++i) {
+            if(!pushQueue(&children[i], &queue))
+                context->stats.isOutOfMemory = 1;
+        }
+    }
+
+    //the queue and the closed set are all the memory the search takes
+    context->stats.memoryUsed = queue.capacity * sizeof(Node) + closedSetBytes(closed);
+    destroyQueue(&queue);
+
+    //get solution path in order from the root, if it exists
+    if(isGoalFound)
+        pathHead = traceClosedPath(context, closed, goal);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, "bfs");
+
+    return pathHead;
+}
+
+/**
+ * DESCRIPTION:
+ *    Our weighted A* implemetation. Nodes are expanded in order of g + w * h, so
+ *    weights above 1 head for the goal sooner, in exchange for solutions that
+ *    may be up to `weight` times longer than the optimum.
+ * PARAMETERS:
+ *    context   - the search context to record statistics in
+ *    initial   - address to the initial state
+ *    goal      - address to the goal state
+ *    heuristic - the heuristic bound to `goal`; NULL for the Manhattan distance
+ *    weight    - the weight of the heuristic value, at least 1; 1 for A*
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* WeightedAStar_search(SearchContext * const context, State *initial, State *goal, Heuristic const *heuristic,
+        double weight) {
+    NodeHeap openList = { 0, 0, NULL, weight > 1? weight : 1, &context->memoryLeft };
+    Node node, children[4];
+    State state;
+    SolutionPath *pathHead = NULL;
+    unsigned int childCount, i;
+    char isGoalFound = 0;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    //fall back to the Manhattan distance to the goal board
+    ManhattanTable distances;
+    Heuristic manhattan;
+    if(!heuristic) {
+        buildManhattanTable(goal, &distances);
+        useManhattan(&manhattan, &distances);
+        heuristic = &manhattan;
+    }
+
+    //best path cost of each board reached, so that it is only reopened on a shorter path
+    ClosedSet *closed = acquireClosedSet(context);
+    if(!closed)
+        return NULL;
+    updateClosedSet(closed, initial, 0);
+
+    //initialize the open list with the root node of the search tree
+    createNode(context, 0, heuristic->evaluate(heuristic->data, initial), initial, &node);
+    if(!pushHeap(&node, &openList))
+        context->stats.isOutOfMemory = 1;
+
+    //while there is a node in the open list to expand, pop the one with the lowest total cost
+    while(!context->stats.isOutOfMemory && popHeap(&openList, &node)) {
+        PROFILE_EXPANSION(openList.nodeCount, totalCost(&node));
+
+        //skip nodes whose board was reached more cheaply since they were pushed
+        nodeState(&node, &state);
+        if(node.depth > readClosedDepth(closed, &state))
+            continue;
+
+        //if the state of the node is the goal state
+        if(node.board == goal->board) {
+            isGoalFound = 1;
+            break;
+        }
+
+        //else, expand the node and update the expanded-nodes counter
+        childCount = getChildren(&node, heuristic, closed, context, children);
+        ++context->stats.nodesExpanded;
+
+        //add the node's children to the open list; a search that runs out of memory gives up
+        for(i = 0; i < childCount; ++i) {
+            if(!pushHeap(&children[i], &openList))
+                context->stats.isOutOfMemory = 1;
+        }
+    }
+
+    //the open list and the closed set are all the memory the search takes
+    context->stats.memoryUsed = openList.capacity * sizeof(Node) + closedSetBytes(closed);
+    destroyHeap(&openList);
+
+    //get solution path in order from the root, if it exists
+    if(isGoalFound)
+        pathHead = traceClosedPath(context, closed, goal);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, openList.weight > 1? "wastar" : "astar");
+
+    return pathHead;
+}
+
+/**
+ * DESCRIPTION:
+ *    Our A* implemetation, i.e. weighted A* with a weight of 1. Its solutions are
+ *    optimal, as long as the heuristic never overestimates.
+ * PARAMETERS:
+ *    context   - the search context to record statistics in
+ *    initial   - address to the initial state
+ *    goal      - address to the goal state
+ *    heuristic - the heuristic bound to `goal`; NULL for the Manhattan distance
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* AStar_search(SearchContext * const context, State *initial, State *goal, Heuristic const *heuristic) {
+    return WeightedAStar_search(context, initial, goal, heuristic, 1);
+}
+
+#define ANYTIME_WEIGHT 2.0          //default weight of weighted A* and of the first anytime A* solution
+#define ANYTIME_WEIGHT_STEP 0.5     //default amount the anytime A* weight is lowered by after each solution
+#define ANYTIME_CLOCK_INTERVAL 1024 //expansions between two checks of the anytime A* time limit
+
+/**
+ * DESCRIPTION: The progress of the anytime A*, reported with each shorter solution found.
+**/
+typedef struct AnytimeProgress {
+    unsigned int incumbentLength;  //length of the best solution found so far
+    unsigned int lowerBound;       //length no solution can be shorter than
+    double bound;                  //incumbentLength / lowerBound; 1 once the incumbent is proven optimal
+    double weight;                 //weight of the search that found the incumbent
+    double elapsed;                //seconds since the search started
+    SolutionPath const *solution;  //the incumbent solution, owned by the search
+} AnytimeProgress;
+
+/**
+ * DESCRIPTION: The weight schedule and the limits of the anytime A*.
+**/
+typedef struct AnytimeOptions {
+    double weight;             //weight of the first solution, at least 1; also the weight of weighted A*
+    double weightStep;         //amount the weight is lowered by after each solution, down to 1
+    double timeLimit;          //seconds after which the incumbent is returned; 0 for no limit
+    char (*report)(void *data, AnytimeProgress const *progress); //called with each incumbent;
+                               //the search stops if it returns 0. May be NULL.
+    void *data;                //passed to `report`
+} AnytimeOptions;
+
+/**
+ * DESCRIPTION:
+ *    This finds the lowest total cost in the open list. With a heuristic that
+ *    never overestimates, no solution through the open nodes, and so no solution
+ *    shorter than the incumbent, can be shorter than it.
+ * RETURN:
+ *    Returns the lowest total cost of the open list, at most `incumbent`.
+**/
+unsigned int openLowerBound(NodeHeap const *heap, unsigned int incumbent) {
+    unsigned int bound = incumbent, i;
+
+    for(i = 0; i < heap->nodeCount; ++i) {
+        if((unsigned int)totalCost(&heap->nodes[i]) < bound)
+            bound = totalCost(&heap->nodes[i]);
+    }
+    return bound;
+}
+
+/**
+ * DESCRIPTION:
+ *    Our anytime A* implementation, after ARA*. It starts as weighted A* to find
+ *    a first solution fast, then lowers the weight after each solution and goes
+ *    on from the open list and closed set it has built so far, rather than
+ *    starting over. Nodes that cannot lead to a solution shorter than the
+ *    incumbent are pruned. It stops once the incumbent is proven optimal, when
+ *    the time limit is reached, or when `report` asks it to, and returns the
+ *    incumbent; `stats.bound` tells how far from the optimum it may be.
+ * PARAMETERS:
+ *    context   - the search context to record statistics in
+ *    initial   - address to the initial state
+ *    goal      - address to the goal state
+ *    heuristic - the heuristic bound to `goal`; NULL for the Manhattan distance
+ *    options   - the weight schedule, the time limit and the progress callback
+ * RETURN:
+ *    Returns the best solution found in a linked list; NULL if none is found.
+**/
+SolutionPath* AnytimeAStar_search(SearchContext * const context, State *initial, State *goal, Heuristic const *heuristic,
+        AnytimeOptions const *options) {
+    NodeHeap openList = { 0, 0, NULL, options->weight > 1? options->weight : 1, &context->memoryLeft };
+    Node node, children[4];
+    SolutionPath *pathHead = NULL;
+    SolutionPath *solution;
+    AnytimeProgress progress;
+    State state;
+    unsigned int incumbent = UNVISITED_DEPTH; //length of the best solution so far; none yet
+    unsigned int childCount, i;
+    char isStopped = 0, isProven = 0;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    //fall back to the Manhattan distance to the goal board
+    ManhattanTable distances;
+    Heuristic manhattan;
+    if(!heuristic) {
+        buildManhattanTable(goal, &distances);
+        useManhattan(&manhattan, &distances);
+        heuristic = &manhattan;
+    }
+
+    //best path cost of each board reached, kept across the weights
+    ClosedSet *closed = acquireClosedSet(context);
+    if(!closed)
+        return NULL;
+    updateClosedSet(closed, initial, 0);
+
+    createNode(context, 0, heuristic->evaluate(heuristic->data, initial), initial, &node);
+    if(!pushHeap(&node, &openList))
+        context->stats.isOutOfMemory = 1;
+
+    //a search that runs out of memory returns the incumbent, if any
+    while(!isStopped && !context->stats.isOutOfMemory) {
+        if(!popHeap(&openList, &node)) {
+            //every node that could lead to a shorter solution has been expanded
+            isProven = 1;
+            break;
+        }
+        PROFILE_EXPANSION(openList.nodeCount, totalCost(&node));
+
+        //skip nodes that cannot beat the incumbent, and those reached more cheaply since
+        nodeState(&node, &state);
+        if((unsigned int)totalCost(&node) >= incumbent || node.depth > readClosedDepth(closed, &state))
+            continue;
+
+        if(node.board == goal->board) {
+            solution = traceClosedPath(context, closed, goal);
+            if(!solution)
+                break;
+
+            destroySolution(&pathHead);
+            pathHead = solution;
+            incumbent = context->stats.solutionLength;
+
+            progress.incumbentLength = incumbent;
+            progress.lowerBound = openLowerBound(&openList, incumbent);
+            progress.bound = progress.lowerBound? (double)incumbent / progress.lowerBound : 1;
+            progress.weight = openList.weight;
+            progress.elapsed = readClock() - start;
+            progress.solution = pathHead;
+
+            isProven = progress.lowerBound >= incumbent;
+            if(options->report && !options->report(options->data, &progress))
+                break;
+            if(isProven)
+                break;
+
+            //go on with a lower weight, from the nodes generated so far
+            reweighHeap(&openList, openList.weight - options->weightStep > 1? openList.weight - options->weightStep : 1);
+            continue;
+        }
+
+        childCount = getChildren(&node, heuristic, closed, context, children);
+        ++context->stats.nodesExpanded;
+
+        for(i = 0; i < childCount; ++i) {
+            if((unsigned int)totalCost(&children[i]) < incumbent && !pushHeap(&children[i], &openList))
+                context->stats.isOutOfMemory = 1;
+        }
+
+        if(options->timeLimit > 0 && context->stats.nodesExpanded % ANYTIME_CLOCK_INTERVAL == 0)
+            isStopped = readClock() - start >= options->timeLimit;
+    }
+
+    //the ratio of the incumbent to the lowest length still possible
+    if(pathHead) {
+        unsigned int lowerBound = isProven? incumbent : openLowerBound(&openList, incumbent);
+        context->stats.bound = lowerBound? (double)incumbent / lowerBound : 1;
+    }
+
+    context->stats.memoryUsed = openList.capacity * sizeof(Node) + closedSetBytes(closed);
+    destroyHeap(&openList);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, "arastar");
+
+    return pathHead;
+}
+
+#define MAX_SOLUTION_LENGTH 256 //deepest cost threshold IDA* will attempt
+#define IDA_FOUND UINT_MAX      //returned by `idaDepthFirst()` when the goal is reached
+
+/**
+ * DESCRIPTION:
+ *    The depth-first probe of IDA*. The board of `state` is modified in place
+ *    for each move and restored before returning, so no nodes are allocated.
+ * PARAMETERS:
+ *    context   - the search context to record statistics in
+ *    state     - the board being searched, at a path cost of `depth`
+ *    depth     - the path cost of `state`
+ *    hCost     - the heuristic value of `state`
+ *    bound     - the total cost threshold of the current iteration
+ *    goal      - address to the goal state
+ *    heuristic - the heuristic bound to `goal`
+ *    path      - the moves applied so far; the solution is left here when found
+ * RETURN:
+ *    Returns `IDA_FOUND` if the goal is reached, otherwise the lowest total cost
+ *    exceeding `bound`, to be used as the threshold of the next iteration.
+**/
+unsigned int idaDepthFirst(SearchContext * const context, State *state, unsigned int depth, unsigned int hCost, unsigned int bound,
+        State const *goal, Heuristic const *heuristic, Move *path) {
+    unsigned int cost = depth + hCost;
+    unsigned int nextBound = UINT_MAX - 1;
+    unsigned int result;
+
+    if(cost > bound)
+        return cost;
+    if(statesMatch(state, goal)) {
+        context->stats.solutionLength = depth;
+        return IDA_FOUND;
+    }
+    if(depth == MAX_SOLUTION_LENGTH)
+        return nextBound;
+
+    State parent = *state; //to undo each move with
+    unsigned int childCost;
+    Move move;
+
+    ++context->stats.nodesExpanded;
+    //the recursion stack stands in for the open list
+    PROFILE_EXPANSION(depth, cost);
+
+    for(move = UP; move <= RIGHT; ++move) {
+        if(parent.action == reverseMove[move] || !createState(state, move, state))
+            continue;
+
+        ++context->stats.nodesGenerated;
+        path[depth] = move;
+        childCost = heuristic->update(heuristic->data, &parent, state, hCost);
+
+        result = idaDepthFirst(context, state, depth + 1, childCost, bound, goal, heuristic, path);
+        if(result == IDA_FOUND)
+            return IDA_FOUND;
+        if(result < nextBound)
+            nextBound = result;
+
+        //undo the move
+        *state = parent;
+    }
+
+    return nextBound;
+}
+
+/**
+ * DESCRIPTION:
+ *    Our iterative-deepening A* implementation. It repeats a depth-first search
+ *    bounded by the total cost, raising the bound to the lowest total cost that
+ *    exceeded it, until the goal is reached. Memory use is linear in the
+ *    solution length.
+ * PARAMETERS:
+ *    context   - the search context to record statistics in
+ *    initial   - address to the initial state
+ *    goal      - address to the goal state
+ *    heuristic - the heuristic bound to `goal`; NULL for the Manhattan distance
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* IDAStar_search(SearchContext * const context, State *initial, State *goal, Heuristic const *heuristic) {
+    Move path[MAX_SOLUTION_LENGTH]; //moves of the current probe
+    State state = *initial;          //the single board every move is applied to
+    unsigned int hCost, bound, result;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    //fall back to the Manhattan distance to the goal board
+    ManhattanTable distances;
+    Heuristic manhattan;
+    if(!heuristic) {
+        buildManhattanTable(goal, &distances);
+        useManhattan(&manhattan, &distances);
+        heuristic = &manhattan;
+    }
+
+    //the root counts as generated, as in the other searches
+    ++context->stats.nodesGenerated;
+    hCost = heuristic->evaluate(heuristic->data, initial);
+    bound = hCost;
+
+    do {
+        result = idaDepthFirst(context, &state, 0, hCost, bound, goal, heuristic, path);
+        bound = result;
+    } while(result != IDA_FOUND && result <= MAX_SOLUTION_LENGTH);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, "idastar");
+
+    //the solution, if any, is longer than the deepest threshold
+    if(result != IDA_FOUND) {
+        context->stats.isTooDeep = 1;
+        return NULL;
+    }
+
+    //only the board and the move buffer are kept, whatever the depth
+    context->stats.memoryUsed = sizeof(state) + sizeof(path);
+
+    return createSolution(path, context->stats.solutionLength);
+}
+
+#define INITIAL_FRONTIER_CAPACITY 256 //number of state slots allocated on first push
+#define FORWARD_SIDE 0                //the side searching from the initial state
+#define BACKWARD_SIDE 1               //the side searching from the goal state
+
+//the entry the bidirectional search records for a board in the closed set: the
+//side that reached it in bit 3, and the move it was reached with in bits 0-2
+#define SIDE_TAG(side, move) ((side) << 3 | (move))
+#define TAG_SIDE(tag) ((tag) >> 3)
+#define TAG_MOVE(tag) ((Move)((tag) & 7))
+
+/**
+ * DESCRIPTION:
+ *    A level of the bidirectional search: a growable array of the boards at one
+ *    depth, each holding the move it was reached with.
+**/
+typedef struct Frontier {
+    State *states;             //the boards of the level
+    size_t count;              //number of boards in the level
+    size_t capacity;           //number of slots allocated for `states`
+    size_t *budget;            //the bytes the search may still allocate, charged as the
+                               //level grows; NULL for no limit
+} Frontier;
+
+/**
+ * DESCRIPTION: This appends `state` to `frontier`, growing its array as needed.
+ * RETURN:
+ *    Returns 1 on success; 0 if the level cannot grow within its budget or
+ *    memory runs out.
+**/
+char pushFrontier(Frontier * const frontier, State const *state) {
+    if(frontier->count == frontier->capacity) {
+        size_t capacity = frontier->capacity? frontier->capacity * 2 : INITIAL_FRONTIER_CAPACITY;
+        State *states = chargeMemory(frontier->budget, (capacity - frontier->capacity) * sizeof(State))?
+            realloc(frontier->states, capacity * sizeof(State)) : NULL;
+        if(!states)
+            return 0;
+
+        frontier->states = states;
+        frontier->capacity = capacity;
+    }
+
+    frontier->states[frontier->count++] = *state;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This follows the moves recorded by the bidirectional search from `state`
+ *    back to the root of its side.
+ * PARAMETERS:
+ *    closed - the closed set the moves are recorded in
+ *    state  - the board to start from
+ *    moves  - where the recorded moves are written to, from `state` to the root
+ * RETURN:
+ *    Returns the number of moves written.
+**/
+unsigned int traceSide(ClosedSet *closed, State state, Move *moves) {
+    unsigned int count = 0;
+    Move move;
+
+    while(count < MAX_SOLUTION_LENGTH && (move = TAG_MOVE(readClosedDepth(closed, &state))) != NOT_APPLICABLE) {
+        moves[count++] = move;
+        createState(&state, reverseMove[move], &state);
+    }
+    return count;
+}
+
+/**
+ * DESCRIPTION:
+ *    This joins the two halves of a bidirectional search that met between the
+ *    boards `forward`, reached from the initial state, and `backward`, reached
+ *    from the goal state, which are one `move` apart.
+ * RETURN:
+ *    Returns the solution in a linked list, or NULL on failure.
+**/
+SolutionPath* spliceSides(SearchContext * const context, ClosedSet *closed, State const *forward, Move move,
+        State const *backward) {
+    Move half[MAX_SOLUTION_LENGTH];       //moves of a side, from its meeting board to its root
+    Move path[2 * MAX_SOLUTION_LENGTH + 1];
+    unsigned int count, i, length = 0;
+
+    //the forward half is recorded in reverse order
+    count = traceSide(closed, *forward, half);
+    while(count > 0) {
+        path[length++] = half[--count];
+    }
+
+    path[length++] = move;
+
+    //the backward half is recorded in order, but as the moves leading away from the goal
+    count = traceSide(closed, *backward, half);
+    for(i = 0; i < count; ++i) {
+        path[length++] = reverseMove[half[i]];
+    }
+
+    context->stats.solutionLength = length;
+    return createSolution(path, length);
+}
+
+/**
+ * DESCRIPTION:
+ *    Our bidirectional breadth-first search. It grows one frontier from the
+ *    initial state and one from the goal state, always expanding a whole level
+ *    of the smaller one, so neither grows much past the square root of what a
+ *    one-sided search would hold. Every board reached is recorded in the closed
+ *    set with its side and move, which both detects where the frontiers meet
+ *    and lets each half of the path be traced back without any tree nodes.
+ *    Since a level is only expanded once the other side has reached every board
+ *    within its depth, the first meeting found gives a shortest path.
+ * PARAMETERS:
+ *    context - the search context to allocate from and record statistics in
+ *    initial - address to the initial state
+ *    goal    - address to the goal state
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* BidirectionalBFS_search(SearchContext * const context, State *initial, State *goal) {
+    Frontier current[2] = { { NULL, 0, 0, &context->memoryLeft },
+        { NULL, 0, 0, &context->memoryLeft } };               //the level being expanded on each side
+    Frontier next = { NULL, 0, 0, &context->memoryLeft };     //the level being generated
+    SolutionPath *pathHead = NULL;
+    State root[2], state, child;
+    unsigned char *tag;
+    unsigned int side;
+    size_t i, peakBytes = 0;
+    Move move;
+    char isDone = 0;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    ClosedSet *closed = acquireClosedSet(context);
+    if(!closed)
+        return NULL;
+
+    root[FORWARD_SIDE] = *initial;
+    root[BACKWARD_SIDE] = *goal;
+    for(side = FORWARD_SIDE; side <= BACKWARD_SIDE; ++side) {
+        root[side].action = NOT_APPLICABLE;
+        tag = findClosedDepth(closed, &root[side]);
+        if(!tag || !pushFrontier(&current[side], &root[side])) {
+            context->stats.isOutOfMemory = 1;
+            isDone = 1;
+            break;
+        }
+        *tag = SIDE_TAG(side, NOT_APPLICABLE);
+        ++context->stats.nodesGenerated;
+    }
+
+    if(!isDone && statesMatch(initial, goal)) {
+        pathHead = createSolution(NULL, 0);
+        isDone = 1;
+    }
+
+    while(!isDone && current[FORWARD_SIDE].count > 0 && current[BACKWARD_SIDE].count > 0) {
+        //expand the smaller frontier by one level
+        side = current[BACKWARD_SIDE].count < current[FORWARD_SIDE].count? BACKWARD_SIDE : FORWARD_SIDE;
+        next.count = 0;
+
+        for(i = 0; !isDone && i < current[side].count; ++i) {
+            state = current[side].states[i];
+            ++context->stats.nodesExpanded;
+
+            for(move = UP; move <= RIGHT; ++move) {
+                if(state.action == reverseMove[move] || !createState(&state, move, &child))
+                    continue;
+
+                tag = findClosedDepth(closed, &child);
+                if(!tag) {
+                    context->stats.isOutOfMemory = 1;
+                    isDone = 1;
+                    break;
+                }
+
+                if(*tag == UNVISITED_DEPTH) {
+                    *tag = SIDE_TAG(side, move);
+                    ++context->stats.nodesGenerated;
+                    if(!pushFrontier(&next, &child)) {
+                        context->stats.isOutOfMemory = 1;
+                        isDone = 1;
+                        break;
+                    }
+                }
+                else if(TAG_SIDE(*tag) != side) {
+                    //the frontiers meet between `state` and `child`
+                    if(side == FORWARD_SIDE)
+                        pathHead = spliceSides(context, closed, &state, move, &child);
+                    else
+                        pathHead = spliceSides(context, closed, &child, reverseMove[move], &state);
+                    isDone = 1;
+                    break;
+                }
+            }
+        }
+
+        if(peakBytes < (current[0].capacity + current[1].capacity + next.capacity) * sizeof(State))
+            peakBytes = (current[0].capacity + current[1].capacity + next.capacity) * sizeof(State);
+
+        //the generated level replaces the expanded one
+        Frontier expanded = current[side];
+        current[side] = next;
+        next = expanded;
+    }
+
+    free(current[FORWARD_SIDE].states);
+    free(current[BACKWARD_SIDE].states);
+    free(next.states);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    context->stats.memoryUsed = peakBytes + closedSetBytes(closed);
+    PROFILE_DUMP(context, "bibfs");
+
+    return pathHead;
+}
@@ -0,0 +1,500 @@
+#define BOUNDED_OPEN 0                //index of the heap of nodes with children left to generate
+#define BOUNDED_LEAF 1                //index of the heap of nodes with no child in memory
+#define BOUNDED_NO_NODE UINT32_MAX    //index standing for no node
+#define BOUNDED_INFINITE_COST USHRT_MAX //the cost of nodes that lead nowhere
+#define BOUNDED_EXPANDING 0x10        //set in the `childMask` of the node being expanded
+#define INITIAL_BOUNDED_CAPACITY 1024 //number of node slots allocated first
+#define BOUNDED_FORGET_FACTOR 1024    //the search gives up once it has forgotten this many times
+                                      //the nodes its budget holds
+
+/**
+ * DESCRIPTION:
+ *    A node of the memory-bounded A*. Unlike the nodes of the open lists, it
+ *    links to its parent: the tree in memory is all the search keeps, with no
+ *    closed set, and the solution is traced back through the parents. Bit `m`
+ *    of `childMask` is set while the child reached by move `m` is in memory;
+ *    until then, `childCost[m]` bounds its total cost from below, raised to the
+ *    cost backed up from it when it was last forgotten.
+**/
+typedef struct BoundedNode {
+    Board board;               //packed board of the node's state
+    uint32_t parent;           //index of the parent; BOUNDED_NO_NODE at the root
+    uint32_t position[2];      //the node's entries in the open heap and the leaf heap;
+                               //`position[BOUNDED_OPEN]` also links the free slots
+    unsigned short fCost;      //total cost, raised to that of the children forgotten
+    unsigned short openCost;   //the lowest of `childCost`, while the node is in the open heap
+    unsigned short childCost[4]; //the lowest total cost of each child not in memory, by move;
+                               //BOUNDED_INFINITE_COST for the others and for dead ends
+    unsigned char depth;       //path cost of the node
+    unsigned char hCost;       //heuristic value of the node
+    unsigned char blank;       //index of the blank cell
+    unsigned char move;        //move that resulted to the board; NOT_APPLICABLE at the root
+    unsigned char childMask;   //the children in memory, by move
+} BoundedNode;
+
+/**
+ * DESCRIPTION:
+ *    An entry of a heap of the memory-bounded A*. The node's key is kept along
+ *    with its index, so that the heap is ordered without reading the nodes.
+**/
+typedef struct BoundedEntry {
+    uint32_t key;              //the key of the node, see `boundedKey()`
+    uint32_t node;             //the index of the node
+} BoundedEntry;
+
+//bytes a slot takes: its node and its entries in both heaps
+#define BOUNDED_SLOT_BYTES (sizeof(BoundedNode) + 2 * sizeof(BoundedEntry))
+
+/**
+ * DESCRIPTION:
+ *    The state of a memory-bounded A*, after SMA*. The nodes are slots of one
+ *    array, grown up to `limit` slots along with the two heaps that index them.
+ *    The open heap holds the nodes with children left to generate, the deepest
+ *    of the lowest cost those children can have on top. The leaf heap holds the
+ *    nodes with no child in memory, the shallowest of the highest total cost on
+ *    top. Both heaps take a slot's worth of entries each, so the budget covers
+ *    all the memory of the search.
+**/
+typedef struct BoundedSearch {
+    BoundedNode *nodes;        //the slots
+    BoundedEntry *heaps[2];    //the open heap and the leaf heap
+    uint32_t heapCount[2];     //number of nodes in each heap
+    uint32_t capacity;         //number of slots allocated
+    uint32_t limit;            //number of slots the memory budget allows
+    uint32_t used;             //slots handed out at least once; those past it are fresh
+    uint32_t freeSlot;         //the last slot released, linked to the previous ones
+    uint32_t count;            //number of nodes in the tree
+    uint64_t forgotten;        //number of nodes forgotten so far
+} BoundedSearch;
+
+/**
+ * DESCRIPTION:
+ *    This gives the key node `i` is ordered by in heap `heap`: its cost there,
+ *    then the deepest first.
+**/
+static inline uint32_t boundedKey(BoundedSearch const *search, unsigned int heap, uint32_t i) {
+    BoundedNode const *node = &search->nodes[i];
+
+    return (heap == BOUNDED_OPEN? node->openCost : node->fCost) * MAX_SOLUTION_LENGTH + MAX_SOLUTION_LENGTH - 1
+        - node->depth;
+}
+
+/**
+ * DESCRIPTION:
+ *    This determines whether key `a` belongs above key `b` in heap `heap`: the
+ *    open heap has the lowest key on top, the leaf heap the highest.
+**/
+static inline char boundedBefore(unsigned int heap, uint32_t a, uint32_t b) {
+    return heap == BOUNDED_OPEN? a < b : a > b;
+}
+
+/**
+ * DESCRIPTION: This writes `moved` into entry `entry` of heap `heap`.
+**/
+static inline void setEntry(BoundedSearch * const search, unsigned int heap, uint32_t entry, BoundedEntry moved) {
+    search->heaps[heap][entry] = moved;
+    search->nodes[moved.node].position[heap] = entry;
+}
+
+/**
+ * DESCRIPTION:
+ *    This places `moved` into entry `entry` of heap `heap`, or above or below it
+ *    where it belongs, moving the entries it passes.
+**/
+void siftEntry(BoundedSearch * const search, unsigned int heap, uint32_t entry, BoundedEntry moved) {
+    BoundedEntry *entries = search->heaps[heap];
+    uint32_t count = search->heapCount[heap], child;
+
+    while(entry > 0 && boundedBefore(heap, moved.key, entries[(entry - 1) / 2].key)) {
+        setEntry(search, heap, entry, entries[(entry - 1) / 2]);
+        entry = (entry - 1) / 2;
+    }
+
+    while((child = 2 * entry + 1) < count) {
+        if(child + 1 < count && boundedBefore(heap, entries[child + 1].key, entries[child].key))
+            ++child;
+        if(!boundedBefore(heap, entries[child].key, moved.key))
+            break;
+
+        setEntry(search, heap, entry, entries[child]);
+        entry = child;
+    }
+    setEntry(search, heap, entry, moved);
+}
+
+/**
+ * DESCRIPTION:
+ *    This adds node `i` to heap `heap`, by its current cost there. The heaps
+ *    have an entry for every slot, so there is always room.
+**/
+void linkNode(BoundedSearch * const search, unsigned int heap, uint32_t i) {
+    BoundedEntry added = { boundedKey(search, heap, i), i };
+
+    siftEntry(search, heap, search->heapCount[heap]++, added);
+}
+
+/**
+ * DESCRIPTION: This removes node `i` from heap `heap`.
+**/
+void unlinkNode(BoundedSearch * const search, unsigned int heap, uint32_t i) {
+    uint32_t entry = search->nodes[i].position[heap];
+
+    if(entry < --search->heapCount[heap])
+        siftEntry(search, heap, entry, search->heaps[heap][search->heapCount[heap]]);
+}
+
+/**
+ * DESCRIPTION:
+ *    This finds the node on top of heap `heap`: the deepest node of the lowest
+ *    cost in the open heap, the shallowest leaf of the highest cost in the leaf
+ *    heap.
+ * RETURN:
+ *    Returns the index of the node; BOUNDED_NO_NODE if the heap is empty.
+**/
+uint32_t topNode(BoundedSearch const *search, unsigned int heap) {
+    return search->heapCount[heap]? search->heaps[heap][0].node : BOUNDED_NO_NODE;
+}
+
+/**
+ * DESCRIPTION:
+ *    This lists node `i` as having children left to generate that cost at least
+ *    `cost`, unless it already has cheaper ones.
+**/
+void openNode(BoundedSearch * const search, uint32_t i, unsigned int cost) {
+    BoundedNode *node = &search->nodes[i];
+
+    if(cost >= node->openCost)
+        return;
+    if(node->openCost != BOUNDED_INFINITE_COST)
+        unlinkNode(search, BOUNDED_OPEN, i);
+    node->openCost = cost;
+    linkNode(search, BOUNDED_OPEN, i);
+}
+
+/**
+ * DESCRIPTION: This removes node `i` from the open heap, if it is listed.
+**/
+void closeNode(BoundedSearch * const search, uint32_t i) {
+    BoundedNode *node = &search->nodes[i];
+
+    if(node->openCost == BOUNDED_INFINITE_COST)
+        return;
+    unlinkNode(search, BOUNDED_OPEN, i);
+    node->openCost = BOUNDED_INFINITE_COST;
+}
+
+/**
+ * DESCRIPTION:
+ *    This hands out a free slot, growing the array and the heaps up to the
+ *    budget. If they cannot grow, the budget is lowered to the slots already
+ *    allocated, so that running out of memory only makes the search forget
+ *    more nodes.
+ * RETURN:
+ *    Returns the index of the slot; BOUNDED_NO_NODE if the budget is used up.
+**/
+uint32_t allocateNode(BoundedSearch * const search) {
+    BoundedNode *nodes;
+    BoundedEntry *open = NULL, *leaves = NULL;
+    uint32_t i, capacity;
+
+    if(search->freeSlot != BOUNDED_NO_NODE) {
+        i = search->freeSlot;
+        search->freeSlot = search->nodes[i].position[BOUNDED_OPEN];
+    }
+    else {
+        if(search->used == search->capacity) {
+            if(search->capacity >= search->limit)
+                return BOUNDED_NO_NODE;
+
+            capacity = search->capacity? search->capacity * 2 : INITIAL_BOUNDED_CAPACITY;
+            if(capacity > search->limit || capacity < search->capacity)
+                capacity = search->limit;
+
+            //the arrays are only taken as grown once all of them are
+            nodes = realloc(search->nodes, (size_t)capacity * sizeof(BoundedNode));
+            if(nodes) {
+                search->nodes = nodes;
+                open = realloc(search->heaps[BOUNDED_OPEN], (size_t)capacity * sizeof(BoundedEntry));
+            }
+            if(open) {
+                search->heaps[BOUNDED_OPEN] = open;
+                leaves = realloc(search->heaps[BOUNDED_LEAF], (size_t)capacity * sizeof(BoundedEntry));
+            }
+            if(!leaves) {
+                search->limit = search->capacity;
+                return BOUNDED_NO_NODE;
+            }
+            search->heaps[BOUNDED_LEAF] = leaves;
+            search->capacity = capacity;
+        }
+        i = search->used++;
+    }
+
+    ++search->count;
+    return i;
+}
+
+/**
+ * DESCRIPTION: This returns slot `i` to the free slots.
+**/
+void releaseNode(BoundedSearch * const search, uint32_t i) {
+    search->nodes[i].position[BOUNDED_OPEN] = search->freeSlot;
+    search->freeSlot = i;
+    --search->count;
+}
+
+/**
+ * DESCRIPTION:
+ *    This forgets the leaf of highest total cost, the shallowest of them. Its
+ *    cost is backed up into its parent, which is opened again to regenerate it
+ *    at that cost, and becomes a leaf once it has no child left.
+ * RETURN:
+ *    Returns 1 if a leaf is forgotten; 0 if there is no leaf to forget.
+**/
+char forgetLeaf(BoundedSearch * const search) {
+    uint32_t i = topNode(search, BOUNDED_LEAF), parentIndex;
+    BoundedNode *node, *parent;
+
+    if(i == BOUNDED_NO_NODE || search->nodes[i].parent == BOUNDED_NO_NODE)
+        return 0;
+
+    node = &search->nodes[i];
+    parentIndex = node->parent;
+    parent = &search->nodes[parentIndex];
+    unlinkNode(search, BOUNDED_LEAF, i);
+    closeNode(search, i);
+
+    parent->childMask &= ~(1 << node->move);
+    parent->childCost[node->move] = node->fCost;
+    if(node->fCost != BOUNDED_INFINITE_COST)
+        openNode(search, parentIndex, node->fCost);
+
+    //the cheapest forgotten child bounds the cost of every path through the parent
+    if(!parent->childMask) {
+        if(parent->fCost < parent->openCost)
+            parent->fCost = parent->openCost;
+        linkNode(search, BOUNDED_LEAF, parentIndex);
+    }
+
+    releaseNode(search, i);
+    ++search->forgotten;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This sets up slot `i` as a node of `state` reached at a path cost of
+ *    `depth`, and lists it as a leaf with children of its total cost to generate.
+**/
+void placeNode(BoundedSearch * const search, uint32_t i, uint32_t parent, State const *state, unsigned int depth,
+        unsigned int hCost, unsigned int fCost) {
+    BoundedNode *node = &search->nodes[i];
+    Move move;
+
+    node->board = state->board;
+    node->parent = parent;
+    node->depth = depth;
+    node->hCost = hCost;
+    node->fCost = fCost;
+    node->openCost = BOUNDED_INFINITE_COST;
+    node->blank = state->blank;
+    node->move = state->action;
+    node->childMask = 0;
+    for(move = UP; move <= RIGHT; ++move) {
+        node->childCost[move] = state->action == reverseMove[move] || moveTable[state->blank][move] < 0?
+            BOUNDED_INFINITE_COST : fCost;
+    }
+
+    linkNode(search, BOUNDED_LEAF, i);
+    openNode(search, i, fCost);
+}
+
+/**
+ * DESCRIPTION: This releases the slots and the heaps of `search`.
+**/
+void destroyBoundedSearch(BoundedSearch * const search) {
+    free(search->nodes);
+    free(search->heaps[BOUNDED_OPEN]);
+    free(search->heaps[BOUNDED_LEAF]);
+}
+
+/**
+ * DESCRIPTION:
+ *    Our memory-bounded A* implementation, after SMA*. It searches as A* does
+ *    while the tree fits in `memoryLimit` bytes. Once it does not, the leaves of
+ *    highest total cost are forgotten, their cost backed up into their parents,
+ *    which regenerate them when no cheaper node is left, the cheapest first. The
+ *    search thus trades time for memory instead of running out, and its
+ *    solutions stay optimal as long as the budget holds the path to the goal. A
+ *    node whose children do not fit in the budget along with its path leads
+ *    nowhere. The search ends marked as out of memory if the budget cannot hold
+ *    the shortest path the heuristic allows, once every path is given up, or
+ *    once it has forgotten BOUNDED_FORGET_FACTOR times the nodes the budget
+ *    holds, which bounds the time a budget too tight to make headway costs.
+ * PARAMETERS:
+ *    context     - the search context to record statistics in
+ *    initial     - address to the initial state
+ *    goal        - address to the goal state
+ *    heuristic   - the heuristic bound to `goal`; NULL for the Manhattan distance
+ *    memoryLimit - the bytes the nodes and the heaps may take
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* SMAStar_search(SearchContext * const context, State *initial, State *goal, Heuristic const *heuristic,
+        size_t memoryLimit) {
+    BoundedSearch search;
+    BoundedNode *node;
+    SolutionPath *pathHead = NULL;
+    Move path[MAX_SOLUTION_LENGTH];  //the moves of the solution, from its end back
+    State state, children[4];
+    Move moves[4];
+    uint32_t slots[4];
+    uint32_t best, root;
+    unsigned int childCount, slotCount, openCost, fCost, i;
+    uint64_t forgetLimit;      //the nodes the search may forget before it gives up
+    char isPruned = 0;         //set once a node is given up for lack of memory
+    Move move;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal))
+        return NULL;
+
+    //fall back to the Manhattan distance to the goal board
+    ManhattanTable distances;
+    Heuristic manhattan;
+    if(!heuristic) {
+        buildManhattanTable(goal, &distances);
+        useManhattan(&manhattan, &distances);
+        heuristic = &manhattan;
+    }
+
+    memset(&search, 0, sizeof(search));
+    search.limit = memoryLimit / BOUNDED_SLOT_BYTES < UINT32_MAX? memoryLimit / BOUNDED_SLOT_BYTES : UINT32_MAX - 1;
+    search.freeSlot = BOUNDED_NO_NODE;
+    forgetLimit = (uint64_t)search.limit * BOUNDED_FORGET_FACTOR;
+
+    //a solution takes at least as many moves as the heuristic tells, and a slot more for its start
+    fCost = heuristic->evaluate(heuristic->data, initial);
+    root = fCost < search.limit? allocateNode(&search) : BOUNDED_NO_NODE;
+    if(root == BOUNDED_NO_NODE) {
+        destroyBoundedSearch(&search);
+        context->stats.isOutOfMemory = 1;
+        context->stats.runtime = readClock() - start;
+        return NULL;
+    }
+
+    state = *initial;
+    state.action = NOT_APPLICABLE;
+    placeNode(&search, root, BOUNDED_NO_NODE, &state, 0, fCost, fCost);
+    ++context->stats.nodesGenerated;
+
+    //expand the node whose children left to generate may cost the least
+    while((best = topNode(&search, BOUNDED_OPEN)) != BOUNDED_NO_NODE) {
+        node = &search.nodes[best];
+        PROFILE_EXPANSION(search.count, node->openCost);
+
+        if(node->board == goal->board)
+            break;
+
+        //a search that keeps forgetting what it regenerates makes no headway within its budget
+        if(search.forgotten > forgetLimit) {
+            context->stats.isOutOfMemory = 1;
+            break;
+        }
+
+        openCost = node->openCost;
+        closeNode(&search, best);
+        if(!node->childMask)
+            unlinkNode(&search, BOUNDED_LEAF, best);
+        node->childMask |= BOUNDED_EXPANDING;
+
+        state.board = node->board;
+        state.blank = node->blank;
+        state.action = (Move)node->move;
+
+        //a node as deep as a solution may be, or whose children cannot fit along with its path, leads nowhere
+        childCount = 0;
+        if(node->depth + 1 >= MAX_SOLUTION_LENGTH || node->depth + 2u > search.limit) {
+            isPruned |= node->depth + 1 < MAX_SOLUTION_LENGTH;
+            context->stats.isTooDeep |= node->depth + 1 >= MAX_SOLUTION_LENGTH;
+            for(move = UP; move <= RIGHT; ++move) {
+                node->childCost[move] = BOUNDED_INFINITE_COST;
+            }
+        }
+        else {
+            //generate the children that may cost the least
+            for(move = UP; move <= RIGHT; ++move) {
+                if(node->childCost[move] == openCost && createState(&state, move, &children[childCount]))
+                    moves[childCount++] = move;
+            }
+        }
+
+        //forgetting leaves may forget children of the node itself, which are generated again later
+        for(slotCount = 0; slotCount < childCount; ) {
+            slots[slotCount] = allocateNode(&search);
+            if(slots[slotCount] != BOUNDED_NO_NODE)
+                ++slotCount;
+            else if(!forgetLeaf(&search))
+                break;
+        }
+
+        //not even the path to the node fits in the budget
+        if(childCount && !slotCount) {
+            context->stats.isOutOfMemory = 1;
+            break;
+        }
+
+        node = &search.nodes[best];
+        for(i = 0; i < slotCount; ++i) {
+            //a child costs no less than its parent's bound of it
+            fCost = node->depth + 1 + heuristic->update(heuristic->data, &state, &children[i], node->hCost);
+            placeNode(&search, slots[i], best, &children[i], node->depth + 1, fCost - node->depth - 1,
+                fCost > openCost? fCost : openCost);
+            node = &search.nodes[best];
+            node->childCost[moves[i]] = BOUNDED_INFINITE_COST;
+            node->childMask |= 1 << moves[i];
+            ++context->stats.nodesGenerated;
+        }
+        ++context->stats.nodesExpanded;
+
+        //the node stays open for the children left to generate, and becomes a leaf without any in memory
+        node->childMask &= ~BOUNDED_EXPANDING;
+        closeNode(&search, best);
+        for(openCost = BOUNDED_INFINITE_COST, move = UP; move <= RIGHT; ++move) {
+            if(node->childCost[move] < openCost)
+                openCost = node->childCost[move];
+        }
+        if(openCost != BOUNDED_INFINITE_COST)
+            openNode(&search, best, openCost);
+        if(!node->childMask) {
+            if(node->fCost < openCost)
+                node->fCost = openCost;
+            linkNode(&search, BOUNDED_LEAF, best);
+        }
+    }
+
+    if(best == BOUNDED_NO_NODE && isPruned)
+        context->stats.isOutOfMemory = 1;
+
+    //follow the parents back from the goal
+    if(best != BOUNDED_NO_NODE && !context->stats.isOutOfMemory) {
+        node = &search.nodes[best];
+        context->stats.solutionLength = node->depth;
+        for(i = node->depth; i > 0; --i, node = &search.nodes[node->parent]) {
+            path[i - 1] = (Move)node->move;
+        }
+        pathHead = createSolution(path, context->stats.solutionLength);
+    }
+
+    context->stats.memoryUsed = (size_t)search.capacity * BOUNDED_SLOT_BYTES;
+    destroyBoundedSearch(&search);
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, "smastar");
+
+    return pathHead;
+}
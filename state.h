@@ -1,144 +1,469 @@
-#define BLANK_CHARACTER '0'
-
-//this enumerates available movements in the game relative to the blank character
-typedef enum Move {
-    UP, DOWN, LEFT, RIGHT, //values for moving up, down, left, right, respectively
-    NOT_APPLICABLE         //value assigned for initial and goal input states
-} Move;
-
-typedef struct State {
-    Move action;           //action that resulted to `this` board state
-    char board[3][3];      //resulting board configuration after applying action
-} State;
-
-/**
- * DESCRIPTION:
- *    This creates a state if `move` is a valid move of the `state` board state.
- * PARAMETERS:
- *    state - pointer to the initial state
- *    move  - action to be applied to the given state
- * RETURN:
- *    Returns a pointer to a new `State` after the move is applied. Returns NULL
- *    upon failure.
-**/
-State* createState(State *state, Move move) {
-    State *newState = malloc(sizeof(State));
-
-    //copy the board configuration of `state` to `newState`
-    //while searching for the row and column of the blank character
-    char i, j;        //used for traversing the 3x3 arrays
-    char row, col;    //coordinates of the blank character
-
-    for(i = 0; i < 3; ++i) {
-        for(j = 0; j < 3; ++j) {
-            if(state->board[i][j] == BLANK_CHARACTER) {
-                row = i;
-                col = j;
-            }
-
-            newState->board[i][j] = state->board[i][j];
-        }
-    }
-
-    //test if the coordinates are valid after translation based on the move
-    //if it is, swap the concerned board values to reflect the move
-    if(move == UP && row - 1 >= 0) {
-        char temp = newState->board[row - 1][col];
-        newState->board[row - 1][col] = BLANK_CHARACTER;
-        newState->board[row][col] = temp;
-        newState->action = UP;
-        return newState;
-    }
-    else if(move == DOWN  && row + 1 < 3) {
-        char temp = newState->board[row + 1][col];
-        newState->board[row + 1][col] = BLANK_CHARACTER;
-        newState->board[row][col] = temp;
-        newState->action = DOWN;
-        return newState;
-    }
-    else if(move == LEFT  && col - 1 >= 0) {
-        char temp = newState->board[row][col - 1];
-        newState->board[row][col - 1] = BLANK_CHARACTER;
-        newState->board[row][col] = temp;
-        newState->action = LEFT;
-        return newState;
-    }
-    else if(move == RIGHT && col + 1 < 3) {
-        char temp = newState->board[row][col + 1];
-        newState->board[row][col + 1] = BLANK_CHARACTER;
-        newState->board[row][col] = temp;
-        newState->action = RIGHT;
-        return newState;
-    }
-
-    free(newState);
-    return NULL;
-}
-
-/**
- * DESCRIPTION: This frees memory of `s` and is reassigned to NULL
-**/
-void destroyState(State **state) {
-    free(*state);
-    state = NULL;
-}
-
-/**
- * DESCRIPTION:
- *    A heuristic function that assigns h-cost to nodes. Lower values
- *    indicate the more closer to the goal.
- * PARAMETER:
- *    curr - the current board configuration
- *    goal - a pointer to the goal configuration of the board
- * RETURN:
- *    Returns a heuristic value greater than or equal to 0.
-**/
-int manhattanDist(State * const curr, State * const goal) {
-    int x0, y0; //used for indexing each symbol in `curr`
-    int x1, y1; //correspoinding row and column of symbol from curr[y0, x0] at `goal`
-    int dx, dy; //change in x0 and x1, and y0 and y1, respectively
-    int sum = 0;
-
-    //for each symbol in `curr`
-    for(y0 = 0; y0 < 3; ++y0) {
-        for(x0 = 0; x0 < 3; ++x0) {
-            //find the coordinates of the same symbol in `goal`
-            for(y1 = 0; y1 < 3; ++y1) {
-                for(x1 = 0; x1 < 3; ++x1) {
-                    if(curr->board[y0][x0] == goal->board[y1][x1]) {
-                        dx = (x0 - x1 < 0)? x1 - x0 : x0 - x1;
-                        dy = (y0 - y1 < 0)? y1 - y0 : y0 - y1;
-                        sum += dx + dy;
-                    }
-                }
-            }
-        }
-    }
-
-    return sum;
-}
-
-/**
- * DESCRIPTION:
- *    This checks whether the two given states match against each other. An alternative
- *    way is to check if the manhattan distance between these two states is zero, but it
- *    would take a more significant amount of time and computational resource
- * PARAMETERS:
- *    state1 - state to match against `state2`
- *    state2 - state to match against `state1`
- * RETURN:
- *    Returns 1 if states match, 0 otherwise.
-**/
-char statesMatch(State const *testState, State const *goalState) {
-    char row = 3, col;
-
-    while(row--) {
-        col = 3;
-        while(col--) {
-            if(testState->board[row][col] != goalState->board[row][col])
-                return 0;
-        }
-    }
-
-    return 1;
-}
\ No newline at end of file
+//the board dimensions; override at compile time, e.g. -DBOARD_ROWS=4 -DBOARD_COLS=4
+#ifndef BOARD_ROWS
+#define BOARD_ROWS 3
+#endif
+#ifndef BOARD_COLS
+#define BOARD_COLS 3
+#endif
+
+#define BOARD_SIZE (BOARD_ROWS * BOARD_COLS) //number of cells, blank included
+#define MAX_BOARD_SIZE 25                    //largest board a `Board` can hold
+#define BLANK_SYMBOL 0                       //symbol representing the blank
+
+#if BOARD_ROWS < 2 || BOARD_COLS < 2 || BOARD_SIZE > MAX_BOARD_SIZE
+#error "The board must be at least 2x2 and have at most 25 cells"
+#endif
+
+//boards of up to 16 cells are packed 4 bits per cell into 64 bits; larger ones
+//need 5 bits per cell, hence the 128-bit integer of GCC and Clang
+#if BOARD_SIZE <= 16
+#define TILE_BITS 4
+typedef uint64_t Board;
+#else
+#define TILE_BITS 5
+typedef unsigned __int128 Board;
+#endif
+
+#define TILE_MASK ((1u << TILE_BITS) - 1)
+
+//this enumerates available movements in the game relative to the blank character
+typedef enum Move {
+    UP, DOWN, LEFT, RIGHT, //values for moving up, down, left, right, respectively
+    NOT_APPLICABLE         //value assigned for initial and goal input states
+} Move;
+
+//the move that would undo each move, indexed by `Move`
+static const Move reverseMove[4] = { DOWN, UP, RIGHT, LEFT };
+
+/**
+ * DESCRIPTION:
+ *    The board configuration is packed in an integer with `TILE_BITS` bits per
+ *    cell, the cell at board[row][col] occupying bits TILE_BITS * (row * BOARD_COLS
+ *    + col) and up. The blank is stored as the symbol 0, and its cell index is
+ *    kept in `blank`.
+**/
+typedef struct State {
+    Move action;           //action that resulted to `this` board state
+    unsigned char blank;   //index (row * BOARD_COLS + col) of the blank cell
+    Board board;           //resulting board configuration after applying action
+} State;
+
+//the cells the blank moves into from cell `i` by moving UP, DOWN, LEFT and RIGHT;
+//-1 if the move would leave the board
+#define MOVE_TARGETS(i) { \
+    (i) >= BOARD_COLS? (i) - BOARD_COLS : -1, \
+    (i) + BOARD_COLS < BOARD_SIZE? (i) + BOARD_COLS : -1, \
+    (i) % BOARD_COLS > 0? (i) - 1 : -1, \
+    (i) % BOARD_COLS < BOARD_COLS - 1? (i) + 1 : -1 }
+
+//index of the cell the blank moves into, for each blank cell index and move;
+//rows past BOARD_SIZE are never used
+static const signed char moveTable[MAX_BOARD_SIZE][4] = {
+    MOVE_TARGETS(0),  MOVE_TARGETS(1),  MOVE_TARGETS(2),  MOVE_TARGETS(3),  MOVE_TARGETS(4),
+    MOVE_TARGETS(5),  MOVE_TARGETS(6),  MOVE_TARGETS(7),  MOVE_TARGETS(8),  MOVE_TARGETS(9),
+    MOVE_TARGETS(10), MOVE_TARGETS(11), MOVE_TARGETS(12), MOVE_TARGETS(13), MOVE_TARGETS(14),
+    MOVE_TARGETS(15), MOVE_TARGETS(16), MOVE_TARGETS(17), MOVE_TARGETS(18), MOVE_TARGETS(19),
+    MOVE_TARGETS(20), MOVE_TARGETS(21), MOVE_TARGETS(22), MOVE_TARGETS(23), MOVE_TARGETS(24)
+};
+
+/**
+ * DESCRIPTION: This returns the symbol at cell `index` of a packed board.
+**/
+unsigned int getTile(Board board, unsigned int index) {
+    return (unsigned int)(board >> (TILE_BITS * index)) & TILE_MASK;
+}
+
+/**
+ * DESCRIPTION:
+ *    This packs a board of symbols 0 to BOARD_SIZE - 1 into `state`. The action of
+ *    the state is left unchanged.
+**/
+void packBoard(unsigned char const board[][BOARD_COLS], State * const state) {
+    unsigned int i;
+
+    state->board = 0;
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        if(board[i / BOARD_COLS][i % BOARD_COLS] == BLANK_SYMBOL)
+            state->blank = i;
+
+        state->board |= (Board)board[i / BOARD_COLS][i % BOARD_COLS] << (TILE_BITS * i);
+    }
+}
+
+/**
+ * DESCRIPTION: This unpacks the board of `state` to symbols 0 to BOARD_SIZE - 1.
+**/
+void unpackBoard(State const *state, unsigned char board[][BOARD_COLS]) {
+    unsigned int i;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        board[i / BOARD_COLS][i % BOARD_COLS] = getTile(state->board, i);
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    This mixes the bits of a packed board into a 64-bit hash, for use in hash
+ *    tables keyed on boards.
+**/
+uint64_t hashBoard(Board board) {
+    uint64_t hash = (uint64_t)board;
+
+#if BOARD_SIZE > 16
+    hash ^= (uint64_t)(board >> 64) * 0x9E3779B97F4A7C15ull;
+#endif
+
+    //finalizer of MurmurHash3
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * DESCRIPTION:
+ *    This creates a state if `move` is a valid move of the `state` board state.
+ *    The blank is swapped with its neighbor by looking up `moveTable`, so no
+ *    scanning or allocation takes place. `newState` may be `state` itself to
+ *    apply the move in place.
+ * PARAMETERS:
+ *    state    - pointer to the initial state
+ *    move     - action to be applied to the given state
+ *    newState - where the state after the move is applied is written to
+ * RETURN:
+ *    Returns 1 if the move is valid and `newState` is written, 0 otherwise.
+**/
+char createState(State const *state, Move move, State * const newState) {
+    PROFILE_BEGIN(PHASE_MOVE_GENERATION);
+    int target = moveTable[state->blank][move];
+    if(target < 0) {
+        PROFILE_END(PHASE_MOVE_GENERATION);
+        return 0;
+    }
+
+    //the blank cell holds 0, so the tile only needs to be cleared from its
+    //cell and or-ed into the blank's cell
+    Board tile = getTile(state->board, target);
+
+    newState->board = (state->board & ~((Board)TILE_MASK << (TILE_BITS * target)))
+        | (tile << (TILE_BITS * state->blank));
+    newState->blank = target;
+    newState->action = move;
+    PROFILE_END(PHASE_MOVE_GENERATION);
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This computes the permutation parity that no move can change: the parity of
+ *    the number of inversions among the tiles read row by row, plus, on boards of
+ *    even width, the row of the blank. A horizontal move changes neither, while a
+ *    vertical move jumps a tile over BOARD_COLS - 1 others, which is an odd number
+ *    of inversions exactly when the width is even.
+ * PARAMETER:
+ *    state - the state to compute the parity of
+ * RETURN:
+ *    Returns 0 or 1.
+**/
+unsigned int permutationParity(State const *state) {
+    unsigned int seen = 0; //bit `n` is set once tile `n` has been read
+    unsigned int inversions = 0;
+    unsigned int i, tile;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        tile = getTile(state->board, i);
+        if(tile == BLANK_SYMBOL)
+            continue;
+
+        //count the tiles greater than `tile` read before it
+        inversions += __builtin_popcount(seen >> tile);
+        seen |= 1u << tile;
+    }
+
+    if(BOARD_COLS % 2 == 0)
+        inversions += state->blank / BOARD_COLS;
+
+    return inversions & 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This checks whether `goal` can be reached from `initial`, which is the case
+ *    for exactly half of all boards. It takes a single pass over each board.
+ * RETURN:
+ *    Returns 1 if the puzzle is solvable, 0 otherwise.
+**/
+char isSolvable(State const *initial, State const *goal) {
+    return permutationParity(initial) == permutationParity(goal);
+}
+
+/**
+ * DESCRIPTION:
+ *    The Manhattan distance of every symbol from every cell to its cell in the
+ *    goal board. It is built once per search so that heuristic values are
+ *    looked up instead of searching the goal board for each symbol.
+**/
+typedef struct ManhattanTable {
+    unsigned char distance[BOARD_SIZE][BOARD_SIZE]; //distance[symbol][cell] to the goal cell of `symbol`
+} ManhattanTable;
+
+/**
+ * DESCRIPTION:
+ *    This fills `table` with the distances of each symbol to its cell in `goal`.
+ *    The blank is given a distance of 0 everywhere so that it is not counted,
+ *    which keeps the heuristic admissible.
+ * PARAMETERS:
+ *    goal  - the goal state of the search
+ *    table - the table to fill
+**/
+void buildManhattanTable(State const *goal, ManhattanTable * const table) {
+    unsigned int symbol, cell, goalCell;
+    int dx, dy;
+
+    for(goalCell = 0; goalCell < BOARD_SIZE; ++goalCell) {
+        symbol = getTile(goal->board, goalCell);
+
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            dx = (int)(cell % BOARD_COLS) - (int)(goalCell % BOARD_COLS);
+            dy = (int)(cell / BOARD_COLS) - (int)(goalCell / BOARD_COLS);
+            table->distance[symbol][cell] = symbol? (dx < 0? -dx : dx) + (dy < 0? -dy : dy) : 0;
+        }
+    }
+}
+
+/**
+ * DESCRIPTION:
+ *    A heuristic function that assigns h-cost to nodes. Lower values
+ *    indicate the more closer to the goal.
+ * PARAMETER:
+ *    curr  - the current board configuration
+ *    table - the distances to the goal board, from `buildManhattanTable()`
+ * RETURN:
+ *    Returns a heuristic value greater than or equal to 0.
+**/
+int manhattanDist(State const *curr, ManhattanTable const *table) {
+    unsigned int cell;
+    int sum = 0;
+    PROFILE_BEGIN(PHASE_HEURISTIC);
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        sum += table->distance[getTile(curr->board, cell)][cell];
+    }
+
+    PROFILE_END(PHASE_HEURISTIC);
+    return sum;
+}
+
+/**
+ * DESCRIPTION:
+ *    This derives the Manhattan distance of a child state from its parent's. A
+ *    move only changes the cell of the tile swapped with the blank, so the tile's
+ *    old distance is replaced with its new one, changing the sum by exactly 1.
+ * PARAMETERS:
+ *    parent - the state the move is applied to
+ *    child  - the state after the move, from `createState()`
+ *    hCost  - the Manhattan distance of `parent`
+ *    table  - the distances to the goal board, from `buildManhattanTable()`
+ * RETURN:
+ *    Returns the Manhattan distance of `child`.
+**/
+int manhattanUpdate(State const *parent, State const *child, int hCost, ManhattanTable const *table) {
+    //the moved tile now sits where the blank of `parent` was
+    PROFILE_BEGIN(PHASE_HEURISTIC);
+    unsigned int tile = getTile(child->board, parent->blank);
+
+    hCost += table->distance[tile][parent->blank] - table->distance[tile][child->blank];
+    PROFILE_END(PHASE_HEURISTIC);
+    return hCost;
+}
+
+/**
+ * DESCRIPTION:
+ *    This checks whether the two given states match against each other. Since
+ *    boards are packed, this is a single integer comparison.
+ * PARAMETERS:
+ *    state1 - state to match against `state2`
+ *    state2 - state to match against `state1`
+ * RETURN:
+ *    Returns 1 if states match, 0 otherwise.
+**/
+char statesMatch(State const *testState, State const *goalState) {
+    return testState->board == goalState->board;
+}
+
+/**
+ * DESCRIPTION:
+ *    This relabels the tiles of `state` after their cells in `goal`, so that
+ *    `goal` itself would become the canonical goal of its blank cell: the tiles
+ *    numbered 1, 2, ... in row-major order, skipping the blank. Moves do not
+ *    depend on the names of the tiles, so the moves solving `state` for `goal`
+ *    solve `canonical` for the canonical goal, and every pair of boards that
+ *    differ only in the names of their tiles is relabelled to the same board.
+ * PARAMETERS:
+ *    state     - the state to relabel
+ *    goal      - the goal state of `state`
+ *    canonical - where the relabelled state is written to
+**/
+void relabelState(State const *state, State const *goal, State * const canonical) {
+    unsigned char label[BOARD_SIZE]; //label[symbol] is the canonical symbol of `symbol`
+    unsigned int cell;
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        label[getTile(goal->board, cell)] = cell < goal->blank? cell + 1 : cell;
+    }
+    label[BLANK_SYMBOL] = BLANK_SYMBOL;
+
+    canonical->board = 0;
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        canonical->board |= (Board)label[getTile(state->board, cell)] << (TILE_BITS * cell);
+    }
+    canonical->blank = state->blank;
+    canonical->action = state->action;
+}
+
+#define MAX_SYMMETRIES 8 //the symmetries of a square: 4 rotations, each with or without a reflection
+
+/**
+ * DESCRIPTION:
+ *    A symmetry of the puzzle for one goal: a rotation or reflection of the
+ *    board that leaves the goal's blank cell in place, followed by the renaming
+ *    of the tiles that carries the goal onto itself. A board and its image are
+ *    the same distance from the goal, and the moves solving one solve the other
+ *    once carried over.
+**/
+typedef struct Symmetry {
+    unsigned char cell[MAX_BOARD_SIZE];  //cell[c] is the cell that cell `c` is carried to
+    unsigned char label[MAX_BOARD_SIZE]; //label[s] is the symbol that symbol `s` is renamed to
+    Move move[4];                        //move[m] is the move that move `m` is carried to
+    Move inverse[4];                     //inverse[m] is the move carried to move `m`
+} Symmetry;
+
+/**
+ * DESCRIPTION: The symmetries of the puzzle for one goal, the identity first.
+**/
+typedef struct SymmetryGroup {
+    unsigned int count;                  //number of symmetries
+    Symmetry symmetries[MAX_SYMMETRIES]; //the symmetries
+} SymmetryGroup;
+
+/**
+ * DESCRIPTION:
+ *    This finds the symmetries of the puzzle for `goal`: the reflections of the
+ *    rows and of the columns, and on square boards the transposition, in every
+ *    combination that keeps the goal's blank cell in place.
+**/
+void buildSymmetryGroup(State const *goal, SymmetryGroup * const group) {
+    static const int rowStep[4] = { -1, 1, 0, 0 }, colStep[4] = { 0, 0, -1, 1 }; //of each move
+    Symmetry *symmetry;
+    unsigned int transform, cell, row, col, swap;
+    int rowDelta, colDelta;
+    Move move, image;
+
+    group->count = 0;
+    for(transform = 0; transform < MAX_SYMMETRIES; ++transform) {
+        //bit 2 transposes, then bit 1 reflects the rows and bit 0 the columns
+        if((transform & 4) && BOARD_ROWS != BOARD_COLS)
+            continue;
+
+        symmetry = &group->symmetries[group->count];
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            row = cell / BOARD_COLS;
+            col = cell % BOARD_COLS;
+            if(transform & 4) {
+                swap = row;
+                row = col;
+                col = swap;
+            }
+            if(transform & 2)
+                row = BOARD_ROWS - 1 - row;
+            if(transform & 1)
+                col = BOARD_COLS - 1 - col;
+            symmetry->cell[cell] = row * BOARD_COLS + col;
+        }
+        if(symmetry->cell[goal->blank] != goal->blank)
+            continue;
+
+        //the tile of each goal cell is renamed after the tile of the cell it is carried to
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            symmetry->label[getTile(goal->board, cell)] = getTile(goal->board, symmetry->cell[cell]);
+        }
+
+        for(move = UP; move <= RIGHT; ++move) {
+            rowDelta = transform & 4? colStep[move] : rowStep[move];
+            colDelta = transform & 4? rowStep[move] : colStep[move];
+            if(transform & 2)
+                rowDelta = -rowDelta;
+            if(transform & 1)
+                colDelta = -colDelta;
+
+            for(image = UP; rowStep[image] != rowDelta || colStep[image] != colDelta; ++image);
+            symmetry->move[move] = image;
+            symmetry->inverse[image] = move;
+        }
+        ++group->count;
+    }
+}
+
+/**
+ * DESCRIPTION: This carries `state` over by `symmetry`, writing the image to `image`.
+**/
+void transformState(Symmetry const *symmetry, State const *state, State * const image) {
+    Board board = 0;
+    unsigned int cell;
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        board |= (Board)symmetry->label[getTile(state->board, cell)] << (TILE_BITS * symmetry->cell[cell]);
+    }
+    image->board = board;
+    image->blank = symmetry->cell[state->blank];
+    image->action = state->action <= RIGHT? symmetry->move[state->action] : state->action;
+}
+
+/**
+ * DESCRIPTION:
+ *    This determines whether `first` comes before `second` in the order of their
+ *    ranks, i.e. whether the first cell where they differ holds a lower symbol
+ *    in `first`.
+**/
+static inline char precedesBoard(Board first, Board second) {
+    Board difference = first ^ second;
+    unsigned int cell;
+
+    if(!difference)
+        return 0;
+#if BOARD_SIZE <= 16
+    cell = __builtin_ctzll(difference) / TILE_BITS;
+#else
+    cell = ((uint64_t)difference? __builtin_ctzll((uint64_t)difference)
+        : 64 + __builtin_ctzll((uint64_t)(difference >> 64))) / TILE_BITS;
+#endif
+    return getTile(first, cell) < getTile(second, cell);
+}
+
+/**
+ * DESCRIPTION:
+ *    This maps `state` to the member of its symmetry class of lowest rank, which
+ *    every member of the class maps to alike.
+ * PARAMETERS:
+ *    group     - the symmetries of the goal of `state`
+ *    state     - the state to map
+ *    canonical - where the member of lowest rank is written to
+ * RETURN:
+ *    Returns the index in `group` of the symmetry carrying `state` to `canonical`.
+**/
+unsigned int canonicalState(SymmetryGroup const *group, State const *state, State * const canonical) {
+    State image;
+    unsigned int i, best = 0;
+
+    *canonical = *state;
+    for(i = 1; i < group->count; ++i) {
+        transformState(&group->symmetries[i], state, &image);
+        if(precedesBoard(image.board, canonical->board)) {
+            *canonical = image;
+            best = i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,390 @@
+#define DISTANCE_TABLE_LIMIT DENSE_RANK_LIMIT //boards with at most this many cells get a table
+#define DISTANCE_FILE_MAGIC "PUZDST02"         //first bytes of a distance table file
+#define MIN_TABLE_SYMMETRIES 4                 //symmetries a goal needs for its table to be reduced
+
+/**
+ * DESCRIPTION:
+ *    The distance of every board to one goal state, indexed by the board's rank
+ *    from `rankState()`. Boards that cannot reach the goal hold UNVISITED_DEPTH.
+ *    With it, a puzzle is solved without searching, by always moving to a
+ *    neighbor one move closer to the goal.
+ *
+ *    When the goal has at least MIN_TABLE_SYMMETRIES symmetries, only the boards
+ *    that are the canonical member of their symmetry class are kept, their
+ *    ranks sorted in `ranks` along with their distances: at 5 bytes per class
+ *    instead of 1 per board, this only pays with that many symmetries.
+**/
+typedef struct DistanceTable {
+    State goal;                //the goal state the table is built for
+    SymmetryGroup symmetries;  //the symmetries of `goal`
+    uint64_t size;             //number of entries of `distance`: BOARD_SIZE!, or the
+                               //number of canonical boards if `ranks` is not NULL
+    uint32_t *ranks;           //the rank of each canonical board, in increasing order;
+                               //NULL if the table holds every board
+    unsigned char *distance;   //the distance of each board, by rank or by entry of `ranks`
+    void *mapping;             //contents of the file the table is mapped
+    size_t mappingSize;        //from, if any, and its size
+} DistanceTable;
+
+/**
+ * DESCRIPTION:
+ *    The header of a distance table file; the ranks, if any, follow it, then the
+ *    distances.
+**/
+typedef struct DistanceFileHeader {
+    char magic[8];                      //DISTANCE_FILE_MAGIC
+    uint32_t rows, cols;                //the board dimensions
+    uint64_t size;                      //as in `DistanceTable`
+    uint32_t isReduced;                 //set if the ranks of the canonical boards follow
+    unsigned char goal[MAX_BOARD_SIZE]; //the goal board, cell by cell
+} DistanceFileHeader;
+
+/**
+ * DESCRIPTION: This computes the number of arrangements of the board, BOARD_SIZE!.
+**/
+uint64_t countBoards(void) {
+    uint64_t count = 1;
+    unsigned int i;
+
+    for(i = 2; i <= BOARD_SIZE; ++i) {
+        count *= i;
+    }
+    return count;
+}
+
+/**
+ * DESCRIPTION: This orders ranks for `qsort()`.
+**/
+int compareRanks(void const *a, void const *b) {
+    uint32_t first = *(uint32_t const *)a, second = *(uint32_t const *)b;
+    return first < second? -1 : first > second;
+}
+
+/**
+ * DESCRIPTION: This looks up the distance of `state` to the goal of `table`.
+**/
+unsigned char readDistance(DistanceTable const *table, State const *state) {
+    State canonical;
+    uint32_t rank;
+    uint64_t low = 0, high = table->size, middle;
+
+    if(!table->ranks)
+        return table->distance[rankState(state)];
+
+    canonicalState(&table->symmetries, state, &canonical);
+    rank = rankState(&canonical);
+    while(low < high) {
+        middle = (low + high) / 2;
+        if(table->ranks[middle] < rank)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low < table->size && table->ranks[low] == rank? table->distance[low] : UNVISITED_DEPTH;
+}
+
+/**
+ * DESCRIPTION:
+ *    This keeps only the canonical boards of a table of every board, given the
+ *    boards it reached in `reached`.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char reduceDistanceTable(DistanceTable * const table, State const *reached, size_t count) {
+    unsigned char *distance;
+    uint32_t *ranks, *shrunk;
+    State canonical;
+    size_t i, classes = 0;
+
+    ranks = malloc(count * sizeof(uint32_t));
+    if(!ranks)
+        return 0;
+
+    for(i = 0; i < count; ++i) {
+        canonicalState(&table->symmetries, &reached[i], &canonical);
+        if(canonical.board == reached[i].board)
+            ranks[classes++] = rankState(&reached[i]);
+    }
+    qsort(ranks, classes, sizeof(uint32_t), compareRanks);
+
+    distance = malloc(classes);
+    if(!distance) {
+        free(ranks);
+        return 0;
+    }
+    for(i = 0; i < classes; ++i) {
+        distance[i] = table->distance[ranks[i]];
+    }
+
+    free(table->distance);
+    shrunk = realloc(ranks, classes * sizeof(uint32_t));
+    table->ranks = shrunk? shrunk : ranks;
+    table->distance = distance;
+    table->size = classes;
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds the table of `goal` with a single backward breadth-first search
+ *    from the goal. Moves can always be undone, so the depth a board is first
+ *    reached at is its distance to the goal. The table is then reduced to the
+ *    canonical boards if the goal has enough symmetries.
+ * PARAMETERS:
+ *    table - the table to build
+ *    goal  - the goal state
+ * RETURN:
+ *    Returns 1 on success; 0 if the board is too large or memory runs out.
+**/
+char buildDistanceTable(DistanceTable * const table, State const *goal) {
+    State *queue;              //boards to expand, in order of distance
+    size_t head = 0, tail = 0;
+    State state, child;
+    unsigned char depth;
+    Move move;
+
+    table->goal = *goal;
+    table->mapping = NULL;
+    table->mappingSize = 0;
+    table->size = countBoards();
+    table->ranks = NULL;
+    table->distance = NULL;
+    buildSymmetryGroup(goal, &table->symmetries);
+
+    if(BOARD_SIZE > DISTANCE_TABLE_LIMIT)
+        return 0;
+
+    //only the half of the boards with the goal's parity is ever queued
+    table->distance = malloc(table->size);
+    queue = malloc(table->size / 2 * sizeof(State));
+    if(!table->distance || !queue) {
+        free(table->distance);
+        free(queue);
+        table->distance = NULL;
+        return 0;
+    }
+
+    memset(table->distance, UNVISITED_DEPTH, table->size);
+    table->distance[rankState(goal)] = 0;
+    queue[tail++] = *goal;
+
+    while(head < tail) {
+        state = queue[head++];
+        depth = table->distance[rankState(&state)];
+
+        for(move = UP; move <= RIGHT; ++move) {
+            if(!createState(&state, move, &child))
+                continue;
+
+            unsigned char *known = &table->distance[rankState(&child)];
+            if(*known == UNVISITED_DEPTH) {
+                *known = depth + 1;
+                queue[tail++] = child;
+            }
+        }
+    }
+
+    if(table->symmetries.count >= MIN_TABLE_SYMMETRIES && !reduceDistanceTable(table, queue, tail)) {
+        free(queue);
+        return 0;
+    }
+
+    free(queue);
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    This writes the table to `path`, to be mapped by `loadDistanceTable()`.
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char saveDistanceTable(DistanceTable const *table, char const *path) {
+    DistanceFileHeader header = { DISTANCE_FILE_MAGIC, BOARD_ROWS, BOARD_COLS, table->size, table->ranks != NULL, { 0 } };
+    unsigned int i;
+    char success = 1;
+    FILE *file = fopen(path, "wb");
+
+    if(!file)
+        return 0;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        header.goal[i] = getTile(table->goal.board, i);
+    }
+    success &= fwrite(&header, sizeof(header), 1, file) == 1;
+    if(table->ranks)
+        success &= fwrite(table->ranks, sizeof(uint32_t), table->size, file) == table->size;
+    success &= fwrite(table->distance, 1, table->size, file) == table->size;
+
+    success &= fclose(file) == 0;
+    return success;
+}
+
+/**
+ * DESCRIPTION:
+ *    This maps the table written by `saveDistanceTable()` into memory. The
+ *    distances are used straight from the mapping, without being copied.
+ * PARAMETERS:
+ *    table - where the table is loaded into
+ *    path  - the file to load
+ *    goal  - the goal state the table must have been built for; NULL to accept
+ *            the table of any goal
+ * RETURN:
+ *    Returns 1 on success; 0 if the file cannot be read, or if it was built for
+ *    another board size or goal.
+**/
+char loadDistanceTable(DistanceTable * const table, char const *path, State const *goal) {
+    size_t size;
+    unsigned char *contents = mapFile(path, &size);
+    DistanceFileHeader const *header = (DistanceFileHeader const *)contents;
+    unsigned char board[BOARD_ROWS][BOARD_COLS];
+    char isNumUsed[BOARD_SIZE] = { 0 };
+    unsigned int i;
+    uint64_t entryBytes;
+
+    if(!contents)
+        return 0;
+
+    if(size < sizeof(DistanceFileHeader) || memcmp(header->magic, DISTANCE_FILE_MAGIC, sizeof(header->magic))
+            || header->rows != BOARD_ROWS || header->cols != BOARD_COLS)
+        goto invalid;
+
+    entryBytes = header->isReduced? 1 + sizeof(uint32_t) : 1;
+    if(header->isReduced? header->size >= countBoards() : header->size != countBoards())
+        goto invalid;
+    if((size - sizeof(DistanceFileHeader)) / entryBytes < header->size)
+        goto invalid;
+
+    for(i = 0; i < BOARD_SIZE; ++i) {
+        if(header->goal[i] >= BOARD_SIZE || isNumUsed[header->goal[i]]
+                || (goal && header->goal[i] != getTile(goal->board, i)))
+            goto invalid;
+
+        isNumUsed[header->goal[i]] = 1;
+        board[i / BOARD_COLS][i % BOARD_COLS] = header->goal[i];
+    }
+
+    table->goal.action = NOT_APPLICABLE;
+    packBoard(board, &table->goal);
+    buildSymmetryGroup(&table->goal, &table->symmetries);
+    table->size = header->size;
+    table->ranks = header->isReduced? (uint32_t *)(contents + sizeof(DistanceFileHeader)) : NULL;
+    table->distance = contents + sizeof(DistanceFileHeader) + (header->isReduced? header->size * sizeof(uint32_t) : 0);
+    table->mapping = contents;
+    table->mappingSize = size;
+    return 1;
+
+invalid:
+    unmapFile(contents, size);
+    table->ranks = NULL;
+    table->distance = NULL;
+    table->mapping = NULL;
+    table->mappingSize = 0;
+    return 0;
+}
+
+/**
+ * DESCRIPTION: This releases the distances of `table`.
+**/
+void destroyDistanceTable(DistanceTable * const table) {
+    if(table->mapping) {
+        unmapFile(table->mapping, table->mappingSize);
+    }
+    else {
+        free(table->ranks);
+        free(table->distance);
+    }
+
+    table->ranks = NULL;
+    table->distance = NULL;
+    table->mapping = NULL;
+    table->mappingSize = 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This maps the table of `goal` from `path`, or builds it and saves it to
+ *    `path` if the file is missing or holds the table of another goal.
+ * RETURN:
+ *    Returns 1 on success; 0 if the board is too large or memory runs out.
+**/
+char prepareDistanceTable(DistanceTable * const table, char const *path, State const *goal) {
+    if(BOARD_SIZE > DISTANCE_TABLE_LIMIT)
+        return 0;
+    if(loadDistanceTable(table, path, goal))
+        return 1;
+
+    fprintf(stderr, "Building distance table...\n");
+    if(!buildDistanceTable(table, goal)) {
+        destroyDistanceTable(table);
+        return 0;
+    }
+    if(!saveDistanceTable(table, path))
+        fprintf(stderr, "WARNING: Could not save the distance table to %s.\n", path);
+
+    return 1;
+}
+
+/**
+ * DESCRIPTION:
+ *    Our table lookup "search". Starting from the initial state, it repeatedly
+ *    takes the move to a neighbor one step closer to the goal, so only the
+ *    neighbors along the solution are ever looked at.
+ * PARAMETERS:
+ *    context - the search context to record statistics in
+ *    table   - the distance table of `goal`
+ *    initial - address to the initial state
+ *    goal    - address to the goal state
+ * RETURN:
+ *    Returns the solution in a linked list; NULL if the solution is not found.
+**/
+SolutionPath* Table_search(SearchContext * const context, DistanceTable const *table, State *initial, State *goal) {
+    Move path[UNVISITED_DEPTH];    //the moves taken so far
+    State state = *initial;
+    State child;
+    unsigned char depth;
+    Move move;
+
+    //start timer
+    beginSearch(context);
+    double start = readClock();
+
+    if(!checkSolvable(context, initial, goal) || !statesMatch(&table->goal, goal))
+        return NULL;
+
+    depth = readDistance(table, initial);
+    ++context->stats.nodesGenerated;
+
+    while(depth > 0 && depth != UNVISITED_DEPTH) {
+        ++context->stats.nodesExpanded;
+
+        for(move = UP; move <= RIGHT; ++move) {
+            if(!createState(&state, move, &child))
+                continue;
+
+            ++context->stats.nodesGenerated;
+            if(readDistance(table, &child) == depth - 1)
+                break;
+        }
+
+        //a table that is not of this goal may leave no way closer
+        if(move > RIGHT)
+            break;
+
+        path[context->stats.solutionLength++] = move;
+        state = child;
+        --depth;
+    }
+
+    //determine the time elapsed
+    context->stats.runtime = readClock() - start;
+    PROFILE_DUMP(context, "table");
+
+    if(depth)
+        return NULL;
+
+    //only the board and the move buffer are kept, whatever the depth
+    context->stats.memoryUsed = sizeof(state) + sizeof(path);
+
+    return createSolution(path, context->stats.solutionLength);
+}
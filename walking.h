@@ -0,0 +1,292 @@
+#define WALKING_LINE_LIMIT 4          //boards with at most this many rows and columns get walking distances
+#define WALKING_COUNT_BITS 3          //bits of each tile count of a distribution key
+#define INITIAL_WALKING_CAPACITY 1024 //number of slots of a new walking distance table
+
+/**
+ * DESCRIPTION:
+ *    The walking distance of every distribution of the tiles over the lines of
+ *    the board (its rows, or its columns). A distribution counts, for each line
+ *    and each goal line, the tiles in that line whose goal is in that goal line;
+ *    it is packed into a key of WALKING_COUNT_BITS bits per count. The walking
+ *    distance relaxes the puzzle to the blank swapping with any tile of a
+ *    neighboring line, so it never overestimates the moves along that direction.
+ *    Distributions are kept in an open-addressing hash table; since every
+ *    distribution holds some tiles, a key of 0 marks an empty slot.
+**/
+typedef struct WalkingTable {
+    uint64_t *keys;            //the distributions reached
+    unsigned char *distance;   //the walking distance of each slot of `keys`
+    size_t capacity;           //number of slots, a power of 2
+    size_t count;              //number of occupied slots
+} WalkingTable;
+
+/**
+ * DESCRIPTION:
+ *    The walking distance heuristic bound to one goal: the walking distance of
+ *    the rows plus that of the columns, as moves along one direction never
+ *    help the other. The key of a board is the sum over its cells of the key of
+ *    one tile in that cell, which is looked up per cell and symbol, so keys are
+ *    computed without any branch.
+**/
+typedef struct WalkingDistance {
+    WalkingTable vertical;                          //distributions of the tiles over the rows
+    WalkingTable horizontal;                        //distributions of the tiles over the columns
+    uint64_t verticalKey[BOARD_SIZE][BOARD_SIZE];   //verticalKey[cell][symbol] of a tile in `cell`
+    uint64_t horizontalKey[BOARD_SIZE][BOARD_SIZE]; //horizontalKey[cell][symbol] of a tile in `cell`
+} WalkingDistance;
+
+/**
+ * DESCRIPTION: This finds the slot of `key` in `table`, or the empty slot where it belongs.
+**/
+static inline size_t probeWalkingTable(WalkingTable const *table, uint64_t key) {
+    size_t i = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (table->capacity - 1);
+
+    while(table->keys[i] && table->keys[i] != key) {
+        i = (i + 1) & (table->capacity - 1);
+    }
+    return i;
+}
+
+/**
+ * DESCRIPTION:
+ *    This records the walking distance of `key`, doubling the table when it
+ *    becomes half full.
+ * RETURN:
+ *    Returns 1 if `key` is new, 0 if it is already recorded; -1 on failure.
+**/
+int addWalkingKey(WalkingTable * const table, uint64_t key, unsigned char distance) {
+    WalkingTable grown;
+    size_t i, slot;
+
+    if(2 * (table->count + 1) > table->capacity) {
+        grown.capacity = table->capacity? 2 * table->capacity : INITIAL_WALKING_CAPACITY;
+        grown.count = table->count;
+        grown.keys = calloc(grown.capacity, sizeof(uint64_t));
+        grown.distance = malloc(grown.capacity);
+        if(!grown.keys || !grown.distance) {
+            free(grown.keys);
+            free(grown.distance);
+            return -1;
+        }
+
+        for(i = 0; i < table->capacity; ++i) {
+            if(table->keys[i]) {
+                slot = probeWalkingTable(&grown, table->keys[i]);
+                grown.keys[slot] = table->keys[i];
+                grown.distance[slot] = table->distance[i];
+            }
+        }
+
+        free(table->keys);
+        free(table->distance);
+        *table = grown;
+    }
+
+    slot = probeWalkingTable(table, key);
+    if(table->keys[slot])
+        return 0;
+
+    table->keys[slot] = key;
+    table->distance[slot] = distance;
+    ++table->count;
+    return 1;
+}
+
+/**
+ * DESCRIPTION: This releases the slots of `table`.
+**/
+void destroyWalkingTable(WalkingTable * const table) {
+    free(table->keys);
+    free(table->distance);
+    table->keys = NULL;
+    table->distance = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds `table` with a breadth-first search from the goal distribution,
+ *    in which every tile is in its goal line. The blank is in the line holding
+ *    one tile less than the others, and moves to a neighboring line by swapping
+ *    with any tile of it.
+ * PARAMETERS:
+ *    table     - the table to build
+ *    lines     - the number of lines of the board
+ *    length    - the number of cells of each line
+ *    blankLine - the line of the blank in the goal
+ * RETURN:
+ *    Returns 1 on success, 0 on failure.
+**/
+char buildWalkingTable(WalkingTable * const table, unsigned int lines, unsigned int length, unsigned int blankLine) {
+    size_t queueCapacity = INITIAL_WALKING_CAPACITY;
+    uint64_t *queue = malloc(queueCapacity * sizeof(uint64_t)); //distributions to expand, in order of distance
+    uint64_t *grown;
+    size_t head = 0, tail = 0;
+    uint64_t key, next, unit, mask = ((uint64_t)1 << WALKING_COUNT_BITS) - 1;
+    unsigned int line, goalLine, count, blank = 0, neighbor;
+    unsigned char distance;
+    int isNew;
+
+    table->keys = NULL;
+    table->distance = NULL;
+    table->capacity = 0;
+    table->count = 0;
+
+    key = 0;
+    for(line = 0; line < lines; ++line) {
+        key += (uint64_t)(line == blankLine? length - 1 : length) << (WALKING_COUNT_BITS * (line * lines + line));
+    }
+
+    if(!queue || addWalkingKey(table, key, 0) < 0)
+        goto failure;
+    queue[tail++] = key;
+
+    while(head < tail) {
+        key = queue[head++];
+        distance = table->distance[probeWalkingTable(table, key)];
+
+        //the blank's line is the one short of a tile
+        for(line = 0; line < lines; ++line) {
+            for(count = 0, goalLine = 0; goalLine < lines; ++goalLine) {
+                count += (key >> (WALKING_COUNT_BITS * (line * lines + goalLine))) & mask;
+            }
+            if(count < length)
+                blank = line;
+        }
+
+        for(neighbor = blank - 1; neighbor != blank + 3; neighbor += 2) {
+            if(neighbor >= lines)
+                continue;
+
+            //swap the blank with a tile of each goal line found in the neighboring line
+            for(goalLine = 0; goalLine < lines; ++goalLine) {
+                unit = (uint64_t)1 << (WALKING_COUNT_BITS * (neighbor * lines + goalLine));
+                if(!(key & unit * mask))
+                    continue;
+
+                next = key - unit + ((uint64_t)1 << (WALKING_COUNT_BITS * (blank * lines + goalLine)));
+                isNew = addWalkingKey(table, next, distance + 1);
+                if(isNew < 0)
+                    goto failure;
+                if(!isNew)
+                    continue;
+
+                if(tail == queueCapacity) {
+                    queueCapacity *= 2;
+                    grown = realloc(queue, queueCapacity * sizeof(uint64_t));
+                    if(!grown)
+                        goto failure;
+                    queue = grown;
+                }
+                queue[tail++] = next;
+            }
+        }
+    }
+
+    free(queue);
+    return 1;
+
+failure:
+    free(queue);
+    destroyWalkingTable(table);
+    return 0;
+}
+
+/**
+ * DESCRIPTION:
+ *    This builds the walking distances of the rows and columns of `goal`.
+ * RETURN:
+ *    Returns 1 on success; 0 if the board has more than WALKING_LINE_LIMIT rows
+ *    or columns, or if memory runs out.
+**/
+char buildWalkingDistance(State const *goal, WalkingDistance * const walking) {
+    unsigned int symbol, cell, goalCell;
+
+    walking->vertical.keys = walking->horizontal.keys = NULL;
+    walking->vertical.distance = walking->horizontal.distance = NULL;
+    walking->vertical.capacity = walking->horizontal.capacity = 0;
+    walking->vertical.count = walking->horizontal.count = 0;
+
+    if(BOARD_ROWS > WALKING_LINE_LIMIT || BOARD_COLS > WALKING_LINE_LIMIT)
+        return 0;
+
+    //the blank counts towards no line
+    memset(walking->verticalKey, 0, sizeof(walking->verticalKey));
+    memset(walking->horizontalKey, 0, sizeof(walking->horizontalKey));
+
+    for(goalCell = 0; goalCell < BOARD_SIZE; ++goalCell) {
+        symbol = getTile(goal->board, goalCell);
+        if(symbol == BLANK_SYMBOL)
+            continue;
+
+        for(cell = 0; cell < BOARD_SIZE; ++cell) {
+            walking->verticalKey[cell][symbol] =
+                (uint64_t)1 << (WALKING_COUNT_BITS * (cell / BOARD_COLS * BOARD_ROWS + goalCell / BOARD_COLS));
+            walking->horizontalKey[cell][symbol] =
+                (uint64_t)1 << (WALKING_COUNT_BITS * (cell % BOARD_COLS * BOARD_COLS + goalCell % BOARD_COLS));
+        }
+    }
+
+    if(!buildWalkingTable(&walking->vertical, BOARD_ROWS, BOARD_COLS, goal->blank / BOARD_COLS)
+            || !buildWalkingTable(&walking->horizontal, BOARD_COLS, BOARD_ROWS, goal->blank % BOARD_COLS)) {
+        destroyWalkingTable(&walking->vertical);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * DESCRIPTION: This releases the tables of `walking`.
+**/
+void destroyWalkingDistance(WalkingDistance * const walking) {
+    destroyWalkingTable(&walking->vertical);
+    destroyWalkingTable(&walking->horizontal);
+}
+
+/**
+ * DESCRIPTION:
+ *    The `evaluate` function of the walking distance. Each distribution of the
+ *    tiles reachable from the goal is in its table, as every board is.
+**/
+unsigned int walkingEvaluate(void const *data, State const *state) {
+    WalkingDistance const *walking = data;
+    uint64_t vertical = 0, horizontal = 0;
+    unsigned int cell, symbol, sum;
+    PROFILE_BEGIN(PHASE_HEURISTIC);
+
+    for(cell = 0; cell < BOARD_SIZE; ++cell) {
+        symbol = getTile(state->board, cell);
+        vertical += walking->verticalKey[cell][symbol];
+        horizontal += walking->horizontalKey[cell][symbol];
+    }
+
+    sum = walking->vertical.distance[probeWalkingTable(&walking->vertical, vertical)]
+        + walking->horizontal.distance[probeWalkingTable(&walking->horizontal, horizontal)];
+
+    PROFILE_END(PHASE_HEURISTIC);
+    return sum;
+}
+
+/**
+ * DESCRIPTION:
+ *    The `update` function of the walking distance. A move changes the
+ *    distribution of one direction only, but recomputing both keys costs no more
+ *    than a pass over the board, so the child is evaluated afresh.
+**/
+unsigned int walkingUpdate(void const *data, State const *parent, State const *child, unsigned int hCost) {
+    (void)parent;
+    (void)hCost;
+    return walkingEvaluate(data, child);
+}
+
+/**
+ * DESCRIPTION:
+ *    This sets up `heuristic` as the walking distance to the goal `walking` was
+ *    built for. The tables must outlive the heuristic.
+**/
+void useWalking(Heuristic * const heuristic, WalkingDistance const *walking) {
+    heuristic->evaluate = walkingEvaluate;
+    heuristic->update = walkingUpdate;
+    heuristic->data = walking;
+}